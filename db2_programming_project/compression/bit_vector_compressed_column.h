@@ -1,12 +1,20 @@
 #pragma once
 
 #include <core/compressed_column.hpp>
+#include <core/roaring_bitmap.hpp>
+#include <boost/unordered_map.hpp>
+#include <boost/serialization/utility.hpp>
 
 namespace CoGaDB{
 
 
 /*!
  *  \brief     This class represents a bit vector compressed column with type T, is the base class for all compressed typed column classes.
+ *  \details   For every distinct value, the column keeps a RoaringBitmap of the rows containing this value. Sparse bitmaps only store
+ *             their set positions, so the memory consumption grows with the number of rows instead of distinct values times rows.
+ *             Selections are answered by bitmap operations: an equality predicate returns the bitmap of its value, range predicates
+ *             the union of the bitmaps of all values fulfilling the predicate.
+ *             sort() sorts the distinct values and concatenates the positions of their bitmaps.
  */
 template<class T>
 class BitVectorCompressedColumn : public CompressedColumn<T>{
@@ -39,14 +47,31 @@ public:
     virtual bool store(const std::string& path);
     virtual bool load(const std::string& path);
 
-
+    virtual const PositionListPtr sort(SortOrder order);
+    virtual const PositionListPtr selection(const boost::any& value_for_comparison, const ValueComparator comp);
+    virtual const PositionListPtr parallel_selection(const boost::any& value_for_comparison, const ValueComparator comp, unsigned int number_of_threads);
+    /*! \brief returns the rows fulfilling the predicate as bitmap, without converting them into a PositionList*/
+    const RoaringBitmap selectionBitmap(const boost::any& value_for_comparison, const ValueComparator comp) const;
 
     virtual T& operator[](const int index);
-
-    /*! values*/
-    std::pair<std::vector<T>, std::vector<std::string> > bitVectorPair;
+    /*! writes the value of each bitmap to the positions it contains in [begin, end), instead of searching all bitmaps per row*/
+    virtual void decode(TID begin, TID end, T* out);
+
+    /*! distinct values (first) and the bitmap of each value (second)*/
+    std::pair<std::vector<T>, std::vector<RoaringBitmap> > bitVectorPair;
+    /*! maps each distinct value to its index in bitVectorPair*/
+    boost::unordered_map<T, unsigned int> valueIndex;
+    unsigned int numberOfRows;
     std::string _name;
 
+protected:
+    /*! computes the new distinct values only, the bitmaps of values that became equal are united*/
+    virtual bool applyOperation(ColumnAlgebraOperation op, const T& operand);
+
+private:
+    /*! returns the index of value in bitVectorPair, a new (empty) bitmap is created for unknown values*/
+    unsigned int getValueIndex(const T& value);
+
 };
 
 
@@ -54,7 +79,7 @@ public:
 
 
     template<class T>
-    BitVectorCompressedColumn<T>::BitVectorCompressedColumn(const std::string& name, AttributeType db_type) : CompressedColumn<T>(name, db_type), bitVectorPair(), _name(name) {
+    BitVectorCompressedColumn<T>::BitVectorCompressedColumn(const std::string& name, AttributeType db_type) : CompressedColumn<T>(name, db_type), bitVectorPair(), valueIndex(), numberOfRows(0), _name(name) {
 
     }
 
@@ -70,34 +95,24 @@ public:
     }
 
     template<class T>
-    bool BitVectorCompressedColumn<T>::insert(const T& new_value) {
-        if(bitVectorPair.first.size() == 0) {
-            bitVectorPair.first.push_back(new_value);
-            bitVectorPair.second.push_back("1");
-            return true;
-        }
-
-        bool wasInserted = false;
-        for(unsigned int i = 0; i < bitVectorPair.first.size(); i++) {
-            if(bitVectorPair.first[i] == new_value) {
-                bitVectorPair.second[i].push_back('1');
-                wasInserted = true;
-            } else {
-                bitVectorPair.second[i].push_back('0');
-            }
+    unsigned int BitVectorCompressedColumn<T>::getValueIndex(const T& value) {
+        typename boost::unordered_map<T, unsigned int>::const_iterator it = valueIndex.find(value);
+        if(it != valueIndex.end()) {
+            return it->second;
         }
 
-        if(wasInserted == false) {
-            bitVectorPair.first.push_back(new_value);
-
-            std::string stringValue = "";
-            for(unsigned int i = 0; i < bitVectorPair.second[0].length() - 1; i++) {
-                stringValue.push_back('0');
-            }
-            stringValue.push_back('1');
-            bitVectorPair.second.push_back(stringValue);
-        }
+        unsigned int index = bitVectorPair.first.size();
+        bitVectorPair.first.push_back(value);
+        bitVectorPair.second.push_back(RoaringBitmap());
+        valueIndex.insert(std::make_pair(value, index));
+        return index;
+    }
 
+    template<class T>
+    bool BitVectorCompressedColumn<T>::insert(const T& new_value) {
+        // Only the bitmap of new_value changes, zero bits of the other values are implicit.
+        bitVectorPair.second[getValueIndex(new_value)].add(numberOfRows);
+        numberOfRows++;
         return true;
     }
 
@@ -121,16 +136,7 @@ public:
 
     template<class T>
     size_t BitVectorCompressedColumn<T>::size() const throw(){
-        int counter = 0;
-        for(unsigned int i = 0; i < bitVectorPair.first.size(); i++) {
-            for(unsigned int j = 0; j < bitVectorPair.second[i].length(); j++) {
-                if(bitVectorPair.second[i][j] == '1') {
-                    counter++;
-                }
-            }
-        }
-
-        return counter;
+        return numberOfRows;
     }
 
     template<class T>
@@ -140,35 +146,18 @@ public:
 
     template<class T>
     bool BitVectorCompressedColumn<T>::update(TID tid, const boost::any& new_value){
-        if(bitVectorPair.second.size() == 0 || tid > bitVectorPair.second[0].length()) {
+        if(tid >= size()) {
             return false;
         }
 
         for(unsigned int i = 0; i < bitVectorPair.second.size(); i++) {
-            if(bitVectorPair.second[i][tid] == '1') {
-                bitVectorPair.second[i][tid] = '0';
+            if(bitVectorPair.second[i].contains(tid)) {
+                bitVectorPair.second[i].remove(tid);
+                break;
             }
         }
 
-        for(unsigned int i = 0; i < bitVectorPair.first.size(); i++) {
-            if(bitVectorPair.first[i] == boost::any_cast<T>(new_value)) {
-                bitVectorPair.second[i][tid] = '1';
-                return true;
-            }
-        }
-
-        bitVectorPair.first.push_back(boost::any_cast<T>(new_value));
-
-        std::string stringValue = "";
-        for(unsigned int i = 0; i < bitVectorPair.second[0].length(); i++) {
-            if(i == tid) {
-                stringValue.push_back('1');
-            } else {
-                stringValue.push_back('0');
-            }
-        }
-        bitVectorPair.second.push_back(stringValue);
-
+        bitVectorPair.second[getValueIndex(boost::any_cast<T>(new_value))].add(tid);
         return true;
     }
 
@@ -180,9 +169,14 @@ public:
 
     template<class T>
     bool BitVectorCompressedColumn<T>::remove(TID tid){
+        if(tid >= size()) {
+            return false;
+        }
+
         for(unsigned int i = 0; i < bitVectorPair.second.size(); i++) {
-            bitVectorPair.second[i].erase(bitVectorPair.second[i].begin() + tid);
+            bitVectorPair.second[i].erasePosition(tid);
         }
+        numberOfRows--;
 
         return true;
     }
@@ -197,6 +191,8 @@ public:
     bool BitVectorCompressedColumn<T>::clearContent(){
         bitVectorPair.first.clear();
         bitVectorPair.second.clear();
+        valueIndex.clear();
+        numberOfRows = 0;
         return true;
     }
 
@@ -208,7 +204,7 @@ public:
         std::ofstream outfile (path.c_str(), std::fstream::out | std::fstream::binary);
         boost::archive::binary_oarchive oa(outfile);
 
-        oa << bitVectorPair;
+        oa << bitVectorPair << numberOfRows;
         outfile.flush();
         outfile.close();
 
@@ -223,16 +219,121 @@ public:
         std::ifstream infile (path.c_str(), std::fstream::in | std::fstream::binary);
         boost::archive::binary_iarchive ia(infile);
 
-        ia >> bitVectorPair;
+        ia >> bitVectorPair >> numberOfRows;
         infile.close();
 
+        valueIndex.clear();
+        for(unsigned int i = 0; i < bitVectorPair.first.size(); i++) {
+            valueIndex.insert(std::make_pair(bitVectorPair.first[i], i));
+        }
+
+        return true;
+    }
+
+    /*! \brief orders indices of distinct values by the values*/
+    template<class T>
+    struct DistinctValueIndexLess{
+        explicit DistinctValueIndexLess(const std::vector<T>& values) : values(values) {}
+        bool operator()(unsigned int a, unsigned int b) const { return values[a] < values[b]; }
+        const std::vector<T>& values;
+    };
+
+    template<class T>
+    const PositionListPtr BitVectorCompressedColumn<T>::sort(SortOrder order){
+        if(order != ASCENDING && order != DESCENDING) {
+            return ColumnBaseTyped<T>::sort(order);
+        }
+
+        std::vector<unsigned int> indicesByValue(bitVectorPair.first.size());
+        for(unsigned int i = 0; i < indicesByValue.size(); i++) {
+            indicesByValue[i] = i;
+        }
+        std::sort(indicesByValue.begin(), indicesByValue.end(), DistinctValueIndexLess<T>(bitVectorPair.first));
+        if(order == DESCENDING) {
+            std::reverse(indicesByValue.begin(), indicesByValue.end());
+        }
+
+        // the positions of a bitmap are ascending, so rows with equal values keep their TID order
+        PositionListPtr ids(new PositionList());
+        ids->reserve(numberOfRows);
+        for(unsigned int i = 0; i < indicesByValue.size(); i++) {
+            bitVectorPair.second[indicesByValue[i]].getPositions(*ids);
+        }
+        return ids;
+    }
+
+    template<class T>
+    const RoaringBitmap BitVectorCompressedColumn<T>::selectionBitmap(const boost::any& value_for_comparison, const ValueComparator comp) const{
+        if(value_for_comparison.type() != typeid(T)) {
+            std::cout << "Fatal Error!!! Typemismatch for column " << this->name_ << std::endl;
+            std::cout << "File: " << __FILE__ << " Line: " << __LINE__ << std::endl;
+            exit(-1);
+        }
+        T value = boost::any_cast<T>(value_for_comparison);
+
+        if(comp == EQUAL) {
+            typename boost::unordered_map<T, unsigned int>::const_iterator it = valueIndex.find(value);
+            if(it == valueIndex.end()) {
+                return RoaringBitmap();
+            }
+            return bitVectorPair.second[it->second];
+        }
+
+        RoaringBitmap result;
+        for(unsigned int i = 0; i < bitVectorPair.first.size(); i++) {
+            if((comp == LESSER && bitVectorPair.first[i] < value) || (comp == GREATER && bitVectorPair.first[i] > value)) {
+                result |= bitVectorPair.second[i];
+            }
+        }
+        return result;
+    }
+
+    template<class T>
+    const PositionListPtr BitVectorCompressedColumn<T>::selection(const boost::any& value_for_comparison, const ValueComparator comp){
+        PositionListPtr result_tids(new PositionList());
+        selectionBitmap(value_for_comparison, comp).getPositions(*result_tids);
+        return result_tids;
+    }
+
+    template<class T>
+    const PositionListPtr BitVectorCompressedColumn<T>::parallel_selection(const boost::any& value_for_comparison, const ValueComparator comp, unsigned int){
+        // the bitmap operations touch only the compressed bitmaps, a row wise scan with several threads would be slower
+        return selection(value_for_comparison, comp);
+    }
+
+    template<class T>
+    bool BitVectorCompressedColumn<T>::applyOperation(ColumnAlgebraOperation op, const T& operand){
+        std::vector<T>& values = bitVectorPair.first;
+        std::vector<RoaringBitmap>& bitmaps = bitVectorPair.second;
+        if(values.empty()) {
+            return true;
+        }
+        apply_operation(&values[0], values.size(), op, operand);
+
+        valueIndex.clear();
+        unsigned int distinctValues = 0;
+        for(unsigned int i = 0; i < values.size(); i++) {
+            typename boost::unordered_map<T, unsigned int>::const_iterator it = valueIndex.find(values[i]);
+            if(it != valueIndex.end()) {
+                bitmaps[it->second] |= bitmaps[i];
+                continue;
+            }
+            if(distinctValues != i) {
+                values[distinctValues] = values[i];
+                bitmaps[distinctValues] = bitmaps[i];
+            }
+            valueIndex.insert(std::make_pair(values[i], distinctValues));
+            distinctValues++;
+        }
+        values.resize(distinctValues);
+        bitmaps.resize(distinctValues);
         return true;
     }
 
     template<class T>
     T& BitVectorCompressedColumn<T>::operator[](const int index){
         for(unsigned int i = 0; i < bitVectorPair.second.size(); i++) {
-            if(bitVectorPair.second[i][index] == '1') {
+            if(bitVectorPair.second[i].contains(index)) {
                 return bitVectorPair.first[i];
             }
         }
@@ -241,10 +342,25 @@ public:
         return bitVectorPair.first[bitVectorPair.first.size()];
     }
 
+    template<class T>
+    void BitVectorCompressedColumn<T>::decode(TID begin, TID end, T* out){
+        PositionList positions;
+        for(unsigned int i = 0; i < bitVectorPair.second.size(); i++) {
+            positions.clear();
+            bitVectorPair.second[i].getPositions(begin, end, positions);
+            for(unsigned int j = 0; j < positions.size(); j++) {
+                out[positions[j] - begin] = bitVectorPair.first[i];
+            }
+        }
+    }
+
     template<class T>
     unsigned int BitVectorCompressedColumn<T>::getSizeinBytes() const throw(){
-        int size = bitVectorPair.first.capacity() * sizeof(T);
-        size += bitVectorPair.second.capacity() * sizeof(std::string);
+        unsigned int size = bitVectorPair.first.capacity() * sizeof(T);
+        size += valueIndex.size() * (sizeof(T) + sizeof(unsigned int));
+        for(unsigned int i = 0; i < bitVectorPair.second.size(); i++) {
+            size += bitVectorPair.second[i].getSizeinBytes();
+        }
         return size;
     }
 
@@ -0,0 +1,404 @@
+#pragma once
+
+#include <core/compressed_column.hpp>
+#include <compression/run_length_compressed_column.hpp>
+#include <boost/unordered_map.hpp>
+#include <algorithm>
+
+namespace CoGaDB{
+
+
+/*!
+ *  \brief     This class represents a cascaded compressed column with type T: a dictionary whose codes are stored in an integer column.
+ *  \details   Every distinct value gets a code, which is its index in the dictionary. The code of each row is stored in the payload,
+ *             an integer column in any encoding, so a dictionary over run length encoded or over PFOR (bit packed) codes is a
+ *             configuration of this class. By default, the codes are run length encoded, which suits sorted low cardinality columns.
+ *             Selections are translated into predicates on the codes and evaluated by the payload in its own encoding. Range
+ *             predicates need a sorted dictionary, which is the case as long as new values are inserted in ascending order.
+ */
+template<class T>
+class CascadedCompressedColumn : public CompressedColumn<T>{
+public:
+    typedef shared_pointer_namespace::shared_ptr<ColumnBaseTyped<int> > PayloadPtr;
+
+    /***************** constructors and destructor *****************/
+    /*! \brief payload has to be an empty integer column, the codes are run length encoded in case it is NULL*/
+    CascadedCompressedColumn(const std::string& name, AttributeType db_type, PayloadPtr payload = PayloadPtr());
+    virtual ~CascadedCompressedColumn();
+
+    virtual bool insert(const boost::any& new_Value);
+    virtual bool insert(const T& new_value);
+    template <typename InputIterator>
+    bool insert(InputIterator first, InputIterator last);
+
+    virtual bool update(TID tid, const boost::any& new_value);
+    virtual bool update(PositionListPtr tid, const boost::any& new_value);
+
+    virtual bool remove(TID tid);
+    //assumes tid list is sorted ascending
+    virtual bool remove(PositionListPtr tid);
+    virtual bool clearContent();
+
+    virtual const boost::any get(TID tid);
+    //virtual const boost::any* const getRawData()=0;
+    virtual void print() const throw();
+    virtual size_t size() const throw();
+    virtual unsigned int getSizeinBytes() const throw();
+
+    virtual const ColumnPtr copy() const;
+
+    virtual bool store(const std::string& path);
+    virtual bool load(const std::string& path);
+
+    virtual const PositionListPtr selection(const boost::any& value_for_comparison, const ValueComparator comp);
+    virtual const PositionListPtr parallel_selection(const boost::any& value_for_comparison, const ValueComparator comp, unsigned int number_of_threads);
+
+    virtual T& operator[](const int index);
+    /*! decodes batches of codes with the decode() of the payload and looks them up in the dictionary*/
+    virtual void decode(TID begin, TID end, T* out);
+    virtual void gather(const TID* tids, size_t count, T* out);
+    virtual bool supportsConcurrentReads() const throw();
+
+    /*! sorts the dictionary, renumbers all codes in the payload and drops values no row refers to, equal values get a single code*/
+    void rebuildDictionary();
+
+    /*! distinct values, the code of a value is its index*/
+    std::vector<T> dictionary;
+    /*! maps each distinct value to its code*/
+    boost::unordered_map<T, int> reverseDictionary;
+    /*! code of each row, stored by the payload in its own encoding under its own name*/
+    PayloadPtr payload;
+    std::string _name;
+    /*! true in case the dictionary is currently sorted ascending, i.e., codes compare like their values*/
+    bool dictionarySorted;
+
+protected:
+    /*! computes the new distinct values only, the payload is only rewritten in case values became equal*/
+    virtual bool applyOperation(ColumnAlgebraOperation op, const T& operand);
+
+private:
+    /*! returns the code of value, unknown values are added to the dictionary*/
+    int encode(const T& value);
+    /*! evaluates a selection on the codes of the payload, with number_of_threads threads in case it is greater than one*/
+    const PositionListPtr selectCodes(const boost::any& value_for_comparison, const ValueComparator comp, unsigned int number_of_threads);
+
+};
+
+
+/***************** Start of Implementation Section ******************/
+
+    template<class T>
+    CascadedCompressedColumn<T>::CascadedCompressedColumn(const std::string& name, AttributeType db_type, PayloadPtr payload)
+        : CompressedColumn<T>(name, db_type), dictionary(), reverseDictionary(), payload(payload), _name(name), dictionarySorted(true) {
+        if(!this->payload) {
+            this->payload = PayloadPtr(new RunLengthCompressedColumn<int>(name + "_codes", INT));
+        }
+    }
+
+    template<class T>
+    CascadedCompressedColumn<T>::~CascadedCompressedColumn(){
+
+    }
+
+    template<class T>
+    bool CascadedCompressedColumn<T>::insert(const boost::any&){
+        // NOT NECESSARY FOR OUR PROGRAMMING TASK (NOT USED BY UNIT TEST).
+        return false;
+    }
+
+    template<class T>
+    int CascadedCompressedColumn<T>::encode(const T& value) {
+        typename boost::unordered_map<T, int>::const_iterator it = reverseDictionary.find(value);
+        if(it != reverseDictionary.end()) {
+            return it->second;
+        }
+
+        int code = dictionary.size();
+        if(!dictionary.empty() && !(dictionary.back() < value)) {
+            dictionarySorted = false;
+        }
+        dictionary.push_back(value);
+        reverseDictionary.insert(std::make_pair(value, code));
+        return code;
+    }
+
+    template<class T>
+    bool CascadedCompressedColumn<T>::insert(const T& new_value) {
+        return payload->insert(encode(new_value));
+    }
+
+    template <typename T>
+    template <typename InputIterator>
+    bool CascadedCompressedColumn<T>::insert(InputIterator first, InputIterator last){
+        for(; first != last; ++first) {
+            if(!payload->insert(encode(*first))) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    template<class T>
+    const boost::any CascadedCompressedColumn<T>::get(TID){
+        // NOT NECESSARY FOR OUR PROGRAMMING TASK (NOT USED BY UNIT TEST).
+        return boost::any();
+    }
+
+    template<class T>
+    void CascadedCompressedColumn<T>::print() const throw(){
+        // NOT NECESSARY FOR OUR PROGRAMMING TASK (NOT USED BY UNIT TEST).
+    }
+
+    template<class T>
+    size_t CascadedCompressedColumn<T>::size() const throw(){
+        return payload->size();
+    }
+
+    template<class T>
+    const ColumnPtr CascadedCompressedColumn<T>::copy() const{
+        CascadedCompressedColumn<T>* column = new CascadedCompressedColumn<T>(*this);
+        // the copy must not share the payload with this column
+        column->payload = shared_pointer_namespace::static_pointer_cast<ColumnBaseTyped<int> >(payload->copy());
+        return ColumnPtr(column);
+    }
+
+    template<class T>
+    bool CascadedCompressedColumn<T>::update(TID tid, const boost::any& new_value){
+        if(tid >= payload->size() || new_value.type() != typeid(T)) {
+            return false;
+        }
+
+        return payload->update(tid, boost::any(encode(boost::any_cast<T>(new_value))));
+    }
+
+    template<class T>
+    bool CascadedCompressedColumn<T>::update(PositionListPtr tids, const boost::any& new_value){
+        if(!tids || new_value.type() != typeid(T)) {
+            return false;
+        }
+
+        // the tids are checked before encoding, so a rejected update leaves the dictionary untouched
+        for(PositionList::const_iterator it = tids->begin(); it != tids->end(); ++it) {
+            if(*it >= payload->size()) {
+                return false;
+            }
+        }
+
+        return payload->update(tids, boost::any(encode(boost::any_cast<T>(new_value))));
+    }
+
+    template<class T>
+    bool CascadedCompressedColumn<T>::remove(TID tid){
+        return payload->remove(tid);
+    }
+
+    template<class T>
+    bool CascadedCompressedColumn<T>::remove(PositionListPtr tids){
+        return payload->remove(tids);
+    }
+
+    template<class T>
+    bool CascadedCompressedColumn<T>::clearContent(){
+        payload->clearContent();
+        dictionary.clear();
+        reverseDictionary.clear();
+        dictionarySorted = true;
+        return true;
+    }
+
+    template<class T>
+    bool CascadedCompressedColumn<T>::store(const std::string& path_){
+        std::string path(path_);
+        path += _name;
+
+        std::ofstream outfile (path.c_str(), std::fstream::out | std::fstream::binary);
+        boost::archive::binary_oarchive oa(outfile);
+
+        oa << dictionary;
+        outfile.flush();
+        outfile.close();
+
+        return payload->store(path_);
+    }
+
+    template<class T>
+    bool CascadedCompressedColumn<T>::load(const std::string& path_){
+        std::string path(path_);
+        path += _name;
+
+        std::ifstream infile (path.c_str(), std::fstream::in | std::fstream::binary);
+        boost::archive::binary_iarchive ia(infile);
+
+        ia >> dictionary;
+        infile.close();
+
+        reverseDictionary.clear();
+        dictionarySorted = true;
+        for(unsigned int i = 0; i < dictionary.size(); i++) {
+            reverseDictionary.insert(std::make_pair(dictionary[i], int(i)));
+            if(i > 0 && !(dictionary[i - 1] < dictionary[i])) {
+                dictionarySorted = false;
+            }
+        }
+
+        return payload->load(path_);
+    }
+
+    template<class T>
+    void CascadedCompressedColumn<T>::rebuildDictionary(){
+        std::vector<int> codes(payload->size());
+        for(unsigned int i = 0; i < codes.size(); i++) {
+            codes[i] = (*payload)[i];
+        }
+
+        std::vector<bool> isUsed(dictionary.size(), false);
+        for(unsigned int i = 0; i < codes.size(); i++) {
+            isUsed[codes[i]] = true;
+        }
+
+        std::vector<T> sortedDictionary;
+        for(unsigned int code = 0; code < dictionary.size(); code++) {
+            if(isUsed[code]) {
+                sortedDictionary.push_back(dictionary[code]);
+            }
+        }
+        std::sort(sortedDictionary.begin(), sortedDictionary.end());
+        sortedDictionary.erase(std::unique(sortedDictionary.begin(), sortedDictionary.end()), sortedDictionary.end());
+
+        // the new code of a value is its position in the sorted dictionary
+        std::vector<int> newCodes(dictionary.size(), 0);
+        for(unsigned int code = 0; code < dictionary.size(); code++) {
+            if(isUsed[code]) {
+                newCodes[code] = std::lower_bound(sortedDictionary.begin(), sortedDictionary.end(), dictionary[code]) - sortedDictionary.begin();
+            }
+        }
+
+        payload->clearContent();
+        for(unsigned int i = 0; i < codes.size(); i++) {
+            payload->insert(newCodes[codes[i]]);
+        }
+
+        dictionary.swap(sortedDictionary);
+        reverseDictionary.clear();
+        for(unsigned int code = 0; code < dictionary.size(); code++) {
+            reverseDictionary.insert(std::make_pair(dictionary[code], int(code)));
+        }
+        dictionarySorted = true;
+    }
+
+    template<class T>
+    bool CascadedCompressedColumn<T>::applyOperation(ColumnAlgebraOperation op, const T& operand){
+        if(dictionary.empty()) {
+            return true;
+        }
+        apply_operation(&dictionary[0], dictionary.size(), op, operand);
+
+        bool isInjective = true;
+        dictionarySorted = true;
+        reverseDictionary.clear();
+        for(unsigned int code = 0; code < dictionary.size(); code++) {
+            isInjective = reverseDictionary.insert(std::make_pair(dictionary[code], int(code))).second && isInjective;
+            if(code > 0 && !(dictionary[code - 1] < dictionary[code])) {
+                dictionarySorted = false;
+            }
+        }
+        // values that became equal (e.g., by an integer division) have to share a code
+        if(!isInjective) {
+            rebuildDictionary();
+        }
+        return true;
+    }
+
+    template<class T>
+    const PositionListPtr CascadedCompressedColumn<T>::selection(const boost::any& value_for_comparison, const ValueComparator comp){
+        return selectCodes(value_for_comparison, comp, 1);
+    }
+
+    template<class T>
+    const PositionListPtr CascadedCompressedColumn<T>::parallel_selection(const boost::any& value_for_comparison, const ValueComparator comp, unsigned int number_of_threads){
+        return selectCodes(value_for_comparison, comp, number_of_threads);
+    }
+
+    template<class T>
+    const PositionListPtr CascadedCompressedColumn<T>::selectCodes(const boost::any& value_for_comparison, const ValueComparator comp, unsigned int number_of_threads){
+        if(value_for_comparison.type() != typeid(T)) {
+            std::cout << "Fatal Error!!! Typemismatch for column " << this->name_ << std::endl;
+            std::cout << "File: " << __FILE__ << " Line: " << __LINE__ << std::endl;
+            exit(-1);
+        }
+        T value = boost::any_cast<T>(value_for_comparison);
+
+        int code = 0;
+        if(comp == EQUAL) {
+            typename boost::unordered_map<T, int>::const_iterator it = reverseDictionary.find(value);
+            if(it == reverseDictionary.end()) {
+                return PositionListPtr(new PositionList());
+            }
+            code = it->second;
+        } else if(!dictionarySorted) {
+            if(number_of_threads <= 1) {
+                return ColumnBaseTyped<T>::selection(value_for_comparison, comp);
+            }
+            return ColumnBaseTyped<T>::parallel_selection(value_for_comparison, comp, number_of_threads);
+        } else if(comp == LESSER) {
+            // the codes of all values lesser than value lie below the first code not lesser than value
+            code = std::lower_bound(dictionary.begin(), dictionary.end(), value) - dictionary.begin();
+        } else {
+            // the codes of all values greater than value start behind the last code not greater than value
+            code = int(std::upper_bound(dictionary.begin(), dictionary.end(), value) - dictionary.begin()) - 1;
+        }
+
+        if(number_of_threads <= 1) {
+            return payload->selection(boost::any(code), comp);
+        }
+        return payload->parallel_selection(boost::any(code), comp, number_of_threads);
+    }
+
+    template<class T>
+    bool CascadedCompressedColumn<T>::supportsConcurrentReads() const throw(){
+        // the codes are read from the payload
+        return payload->supportsConcurrentReads();
+    }
+
+    template<class T>
+    T& CascadedCompressedColumn<T>::operator[](const int index){
+        return dictionary[(*payload)[index]];
+    }
+
+    template<class T>
+    void CascadedCompressedColumn<T>::decode(TID begin, TID end, T* out){
+        int codes[DECODE_BATCH_SIZE];
+        for(TID first = begin; first < end; first += DECODE_BATCH_SIZE) {
+            size_t count = std::min<size_t>(DECODE_BATCH_SIZE, end - first);
+            payload->decode(first, first + count, codes);
+            for(size_t i = 0; i < count; i++) {
+                *out++ = dictionary[codes[i]];
+            }
+        }
+    }
+
+    template<class T>
+    void CascadedCompressedColumn<T>::gather(const TID* tids, size_t count, T* out){
+        int codes[DECODE_BATCH_SIZE];
+        for(size_t first = 0; first < count; first += DECODE_BATCH_SIZE) {
+            size_t batch = std::min<size_t>(DECODE_BATCH_SIZE, count - first);
+            payload->gather(tids + first, batch, codes);
+            for(size_t i = 0; i < batch; i++) {
+                *out++ = dictionary[codes[i]];
+            }
+        }
+    }
+
+    template<class T>
+    unsigned int CascadedCompressedColumn<T>::getSizeinBytes() const throw(){
+        unsigned int size = payload->getSizeinBytes();
+        size += dictionary.capacity() * sizeof(T);
+        size += reverseDictionary.size() * (sizeof(T) + sizeof(int));
+        return size;
+    }
+
+/***************** End of Implementation Section ******************/
+
+
+
+}; //end namespace CogaDB
@@ -0,0 +1,276 @@
+#pragma once
+
+#include <core/column.hpp>
+#include <compression/dictionary_compressed_column.hpp>
+#include <compression/bit_vector_compressed_column.h>
+#include <compression/run_length_compressed_column.hpp>
+#include <compression/delta_compressed_column.h>
+#include <compression/pfor_compressed_column.hpp>
+#include <compression/frequency_partitioned_column.hpp>
+#include <compression/xor_compressed_column.hpp>
+#include <compression/front_coded_compressed_column.hpp>
+#include <compression/cascaded_compressed_column.hpp>
+#include <algorithm>
+
+namespace CoGaDB{
+
+enum ColumnEncoding{UNCOMPRESSED,DICTIONARY_ENCODING,BIT_VECTOR_ENCODING,RUN_LENGTH_ENCODING,DELTA_ENCODING,PFOR_ENCODING,FREQUENCY_PARTITIONING,XOR_ENCODING,FRONT_CODING,
+                    CASCADED_DICTIONARY_RLE,CASCADED_DICTIONARY_PFOR};
+
+/*! \brief returns the name of an encoding*/
+inline const std::string getEncodingName(ColumnEncoding encoding){
+    const char* names[] = {"UNCOMPRESSED", "DICTIONARY_ENCODING", "BIT_VECTOR_ENCODING", "RUN_LENGTH_ENCODING", "DELTA_ENCODING",
+                           "PFOR_ENCODING", "FREQUENCY_PARTITIONING", "XOR_ENCODING", "FRONT_CODING",
+                           "CASCADED_DICTIONARY_RLE", "CASCADED_DICTIONARY_PFOR"};
+    return names[encoding];
+}
+
+/*!
+ *  \brief     Estimated costs of storing a column in one encoding.
+ */
+struct EncodingEstimate{
+    EncodingEstimate() : encoding(UNCOMPRESSED), sizeInBytes(0), scanCost(0), score(0) {}
+
+    ColumnEncoding encoding;
+    /*! estimated main memory consumption of the whole column*/
+    double sizeInBytes;
+    /*! estimated cost of a full scan in bytes: the bytes read plus the decoding work per row, expressed in bytes*/
+    double scanCost;
+    /*! sizeInBytes plus the weighted scanCost, the encoding with the lowest score wins*/
+    double score;
+};
+
+typedef std::vector<EncodingEstimate> EncodingEstimates;
+
+/*!
+ *  \brief     The EncodingFactory creates empty columns of type T in every encoding that supports T.
+ *  \details   Encodings that are restricted to certain types (delta and PFOR to integers, XOR to floating point values and front
+ *             coding to strings) are added by the specializations below.
+ */
+template<class T>
+struct EncodingFactory{
+    /*! \brief returns all encodings that support T*/
+    static std::vector<ColumnEncoding> getEncodings();
+    /*! \brief returns an empty column in encoding, or NULL in case the encoding does not support T*/
+    static ColumnBaseTyped<T>* create(ColumnEncoding encoding, const std::string& name, AttributeType db_type);
+};
+
+/*!
+ *  \brief     The CompressionAdvisor chooses the encoding of a column from a sample of its values.
+ *  \details   The sample consists of evenly spaced chunks of consecutive rows, so runs and small differences between
+ *             neighbouring rows are kept. The sample is encoded in every available encoding, the measured size is scaled to the
+ *             number of rows of the column. The scan cost adds an estimate of the decoding work per row to the size.
+ */
+template<class T>
+class CompressionAdvisor{
+public:
+    /*! \brief scan_weight weights the scan cost against the size of the column*/
+    explicit CompressionAdvisor(double scan_weight = 1.0);
+
+    /*! \brief returns the estimates of all encodings that support T, best encoding first*/
+    const EncodingEstimates estimate(const std::vector<T>& values, AttributeType db_type) const;
+    /*! \brief creates a column in the encoding with the lowest score and inserts values, stores the estimates in estimates unless it is NULL*/
+    const ColumnPtr createColumn(const std::string& name, AttributeType db_type, const std::vector<T>& values, EncodingEstimates* estimates = NULL) const;
+
+    /*! number of chunks of the sample*/
+    static const unsigned int SAMPLE_CHUNKS = 16;
+    /*! number of consecutive rows per chunk of the sample*/
+    static const unsigned int SAMPLE_CHUNK_SIZE = 256;
+
+private:
+    static const std::vector<T> takeSample(const std::vector<T>& values);
+    /*! estimated decoding work per row in bytes during a full scan*/
+    static double getDecodingCostPerRow(ColumnEncoding encoding);
+
+    double scanWeight;
+};
+
+/*! \brief Column factory function, creates a column in the encoding the CompressionAdvisor estimates as best for values and inserts the values*/
+template<class T>
+const ColumnPtr createColumn(AttributeType type, const std::string& name, const std::vector<T>& values, EncodingEstimates* estimates = NULL);
+
+
+/***************** Start of Implementation Section ******************/
+
+    /*! \brief returns the encodings that support every type*/
+    inline std::vector<ColumnEncoding> getCommonEncodings(){
+        std::vector<ColumnEncoding> encodings;
+        encodings.push_back(UNCOMPRESSED);
+        encodings.push_back(DICTIONARY_ENCODING);
+        encodings.push_back(BIT_VECTOR_ENCODING);
+        encodings.push_back(RUN_LENGTH_ENCODING);
+        encodings.push_back(FREQUENCY_PARTITIONING);
+        encodings.push_back(CASCADED_DICTIONARY_RLE);
+        encodings.push_back(CASCADED_DICTIONARY_PFOR);
+        return encodings;
+    }
+
+    /*! \brief returns an empty column in one of the encodings that support every type, or NULL*/
+    template<class T>
+    ColumnBaseTyped<T>* createCommonEncoding(ColumnEncoding encoding, const std::string& name, AttributeType db_type){
+        if(encoding == UNCOMPRESSED) {
+            return new Column<T>(name, db_type);
+        } else if(encoding == DICTIONARY_ENCODING) {
+            return new DictionaryCompressedColumn<T>(name, db_type);
+        } else if(encoding == BIT_VECTOR_ENCODING) {
+            return new BitVectorCompressedColumn<T>(name, db_type);
+        } else if(encoding == RUN_LENGTH_ENCODING) {
+            return new RunLengthCompressedColumn<T>(name, db_type);
+        } else if(encoding == FREQUENCY_PARTITIONING) {
+            return new FrequencyPartitionedColumn<T>(name, db_type);
+        } else if(encoding == CASCADED_DICTIONARY_RLE) {
+            return new CascadedCompressedColumn<T>(name, db_type, typename CascadedCompressedColumn<T>::PayloadPtr(new RunLengthCompressedColumn<int>(name + "_codes", INT)));
+        } else if(encoding == CASCADED_DICTIONARY_PFOR) {
+            return new CascadedCompressedColumn<T>(name, db_type, typename CascadedCompressedColumn<T>::PayloadPtr(new PForCompressedColumn<int>(name + "_codes", INT)));
+        }
+        return NULL;
+    }
+
+    template<class T>
+    std::vector<ColumnEncoding> EncodingFactory<T>::getEncodings(){
+        return getCommonEncodings();
+    }
+
+    template<class T>
+    ColumnBaseTyped<T>* EncodingFactory<T>::create(ColumnEncoding encoding, const std::string& name, AttributeType db_type){
+        return createCommonEncoding<T>(encoding, name, db_type);
+    }
+
+    template<>
+    inline std::vector<ColumnEncoding> EncodingFactory<int>::getEncodings(){
+        std::vector<ColumnEncoding> encodings = getCommonEncodings();
+        encodings.push_back(DELTA_ENCODING);
+        encodings.push_back(PFOR_ENCODING);
+        return encodings;
+    }
+
+    template<>
+    inline ColumnBaseTyped<int>* EncodingFactory<int>::create(ColumnEncoding encoding, const std::string& name, AttributeType db_type){
+        if(encoding == DELTA_ENCODING) {
+            return new DeltaCompressedColumn<int>(name, db_type);
+        } else if(encoding == PFOR_ENCODING) {
+            return new PForCompressedColumn<int>(name, db_type);
+        }
+        return createCommonEncoding<int>(encoding, name, db_type);
+    }
+
+    template<>
+    inline std::vector<ColumnEncoding> EncodingFactory<float>::getEncodings(){
+        std::vector<ColumnEncoding> encodings = getCommonEncodings();
+        encodings.push_back(XOR_ENCODING);
+        return encodings;
+    }
+
+    template<>
+    inline ColumnBaseTyped<float>* EncodingFactory<float>::create(ColumnEncoding encoding, const std::string& name, AttributeType db_type){
+        if(encoding == XOR_ENCODING) {
+            return new XorCompressedColumn<float>(name, db_type);
+        }
+        return createCommonEncoding<float>(encoding, name, db_type);
+    }
+
+    template<>
+    inline std::vector<ColumnEncoding> EncodingFactory<std::string>::getEncodings(){
+        std::vector<ColumnEncoding> encodings = getCommonEncodings();
+        encodings.push_back(FRONT_CODING);
+        return encodings;
+    }
+
+    template<>
+    inline ColumnBaseTyped<std::string>* EncodingFactory<std::string>::create(ColumnEncoding encoding, const std::string& name, AttributeType db_type){
+        if(encoding == FRONT_CODING) {
+            return new FrontCodedCompressedColumn<std::string>(name, db_type);
+        }
+        return createCommonEncoding<std::string>(encoding, name, db_type);
+    }
+
+    template<class T>
+    CompressionAdvisor<T>::CompressionAdvisor(double scan_weight) : scanWeight(scan_weight) {
+
+    }
+
+    template<class T>
+    const std::vector<T> CompressionAdvisor<T>::takeSample(const std::vector<T>& values){
+        if(values.size() <= SAMPLE_CHUNKS * SAMPLE_CHUNK_SIZE) {
+            return values;
+        }
+        std::vector<T> sample;
+        size_t distance = values.size() / SAMPLE_CHUNKS;
+        for(unsigned int chunk = 0; chunk < SAMPLE_CHUNKS; chunk++) {
+            typename std::vector<T>::const_iterator begin = values.begin() + chunk * distance;
+            sample.insert(sample.end(), begin, begin + SAMPLE_CHUNK_SIZE);
+        }
+        return sample;
+    }
+
+    template<class T>
+    double CompressionAdvisor<T>::getDecodingCostPerRow(ColumnEncoding encoding){
+        // Plain values and runs are compared without decoding, bit packed codes need an unpack step, delta, frequency
+        // partitioned and XOR encoded rows are decoded one after another.
+        if(encoding == DICTIONARY_ENCODING || encoding == PFOR_ENCODING || encoding == FRONT_CODING || encoding == CASCADED_DICTIONARY_PFOR) {
+            return 0.25;
+        } else if(encoding == DELTA_ENCODING || encoding == FREQUENCY_PARTITIONING) {
+            return 1;
+        } else if(encoding == XOR_ENCODING) {
+            return 2;
+        }
+        return 0;
+    }
+
+    inline bool compareEncodingEstimates(const EncodingEstimate& a, const EncodingEstimate& b){
+        return a.score < b.score;
+    }
+
+    template<class T>
+    const EncodingEstimates CompressionAdvisor<T>::estimate(const std::vector<T>& values, AttributeType db_type) const{
+        EncodingEstimates estimates;
+        if(values.empty()) {
+            return estimates;
+        }
+
+        const std::vector<T> sample = takeSample(values);
+        double scale = double(values.size()) / sample.size();
+        std::vector<ColumnEncoding> encodings = EncodingFactory<T>::getEncodings();
+        for(unsigned int i = 0; i < encodings.size(); i++) {
+            ColumnBaseTyped<T>* column = EncodingFactory<T>::create(encodings[i], "sample", db_type);
+            for(unsigned int j = 0; j < sample.size(); j++) {
+                column->insert(sample[j]);
+            }
+
+            EncodingEstimate estimate;
+            estimate.encoding = encodings[i];
+            estimate.sizeInBytes = column->getSizeinBytes() * scale;
+            estimate.scanCost = estimate.sizeInBytes + values.size() * getDecodingCostPerRow(encodings[i]);
+            estimate.score = estimate.sizeInBytes + scanWeight * estimate.scanCost;
+            estimates.push_back(estimate);
+            delete column;
+        }
+        std::stable_sort(estimates.begin(), estimates.end(), compareEncodingEstimates);
+        return estimates;
+    }
+
+    template<class T>
+    const ColumnPtr CompressionAdvisor<T>::createColumn(const std::string& name, AttributeType db_type, const std::vector<T>& values, EncodingEstimates* estimates) const{
+        EncodingEstimates result = estimate(values, db_type);
+        ColumnEncoding encoding = result.empty() ? UNCOMPRESSED : result.front().encoding;
+        if(estimates) {
+            *estimates = result;
+        }
+
+        shared_pointer_namespace::shared_ptr<ColumnBaseTyped<T> > column(EncodingFactory<T>::create(encoding, name, db_type));
+        for(unsigned int i = 0; i < values.size(); i++) {
+            column->insert(values[i]);
+        }
+        return column;
+    }
+
+    template<class T>
+    const ColumnPtr createColumn(AttributeType type, const std::string& name, const std::vector<T>& values, EncodingEstimates* estimates){
+        return CompressionAdvisor<T>().createColumn(name, type, values, estimates);
+    }
+
+/***************** End of Implementation Section ******************/
+
+
+
+}; //end namespace CogaDB
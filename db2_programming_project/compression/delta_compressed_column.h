@@ -1,15 +1,28 @@
 #pragma once
 
 #include <core/compressed_column.hpp>
+#include <core/bit_packed_vector.hpp>
+#include <algorithm>
+#include <boost/cstdint.hpp>
+#include <boost/static_assert.hpp>
+#include <boost/type_traits/is_integral.hpp>
 
 namespace CoGaDB{
 
+/*! \brief maximum number of rows in a block of a delta compressed column*/
+const unsigned int DELTA_BLOCK_SIZE = 128;
 
 /*!
  *  \brief     This class represents a delta compressed column with type T, is the base class for all compressed typed column classes.
+ *  \details   The rows are split into blocks of at most DELTA_BLOCK_SIZE rows. Every block stores its first value as absolute base
+ *             and the differences between neighbouring rows zigzag encoded and bit packed with the width of its largest difference.
+ *             The block containing a TID is found by binary search over the block end positions, random access decodes one block
+ *             into a cache, so sequential scans decode every block only once. Updates and deletes re-encode a single block.
  */
 template<class T>
 class DeltaCompressedColumn : public CompressedColumn<T>{
+    // deltas are computed with integer arithmetic
+    BOOST_STATIC_ASSERT(boost::is_integral<T>::value);
 public:
     /***************** constructors and destructor *****************/
     DeltaCompressedColumn(const std::string& name, AttributeType db_type);
@@ -42,11 +55,45 @@ public:
 
 
     virtual T& operator[](const int index);
-
-    /*! values*/
-    std::vector<T> deltaColumn;
+    /*! decodes every block in the range once and copies its values, instead of checking the block cache per row*/
+    virtual void decode(TID begin, TID end, T* out);
+    virtual void gather(const TID* tids, size_t count, T* out);
+    virtual bool supportsConcurrentReads() const throw();
+
+    /*! end position (exclusive) of each block*/
+    std::vector<TID> blockEnds;
+    /*! first value of each block*/
+    std::vector<T> blockBases;
+    /*! zigzag encoded differences between the rows of each block, the first row has no entry*/
+    std::vector<BitPackedVector> blockDeltas;
     std::string _name;
 
+protected:
+    /*! an addition or subtraction only changes the bases, as the differences stay the same, other operations encode every block again*/
+    virtual bool applyOperation(ColumnAlgebraOperation op, const T& operand);
+
+private:
+    /*! returns the index of the block containing tid, or the number of blocks in case tid is out of bounds*/
+    unsigned int findBlock(TID tid) const;
+    /*! returns the position of the first row of a block*/
+    TID getBlockStart(unsigned int block) const;
+    /*! decodes a block into decodedBlock, unless it is already cached*/
+    void decodeBlock(unsigned int block);
+    /*! replaces the encoded data of a block with the values in decodedBlock*/
+    void encodeBlock(unsigned int block);
+    /*! encodes values into a base value and bit packed deltas*/
+    static void encodeValues(const std::vector<T>& values, T& base, BitPackedVector& deltas);
+    /*! removes a block and shifts the end positions of the following blocks*/
+    void eraseBlock(unsigned int block);
+
+    static boost::uint64_t encodeDelta(const T& previous, const T& value);
+    static T decodeDelta(const T& previous, boost::uint64_t delta);
+
+    /*! values of the block with index decodedBlockIndex*/
+    std::vector<T> decodedBlock;
+    /*! index of the cached block, the number of blocks marks an empty cache*/
+    unsigned int decodedBlockIndex;
+
 };
 
 
@@ -54,7 +101,7 @@ public:
 
 
     template<class T>
-    DeltaCompressedColumn<T>::DeltaCompressedColumn(const std::string& name, AttributeType db_type) : CompressedColumn<T>(name, db_type), deltaColumn(), _name(name) {
+    DeltaCompressedColumn<T>::DeltaCompressedColumn(const std::string& name, AttributeType db_type) : CompressedColumn<T>(name, db_type), blockEnds(), blockBases(), blockDeltas(), _name(name), decodedBlock(), decodedBlockIndex(0) {
 
     }
 
@@ -63,6 +110,72 @@ public:
 
     }
 
+    template<class T>
+    boost::uint64_t DeltaCompressedColumn<T>::encodeDelta(const T& previous, const T& value) {
+        // the difference wraps around in unsigned arithmetic, zigzag encoding keeps small negative differences small
+        boost::uint64_t difference = boost::uint64_t(value) - boost::uint64_t(previous);
+        return (difference << 1) ^ boost::uint64_t(boost::int64_t(difference) >> 63);
+    }
+
+    template<class T>
+    T DeltaCompressedColumn<T>::decodeDelta(const T& previous, boost::uint64_t delta) {
+        boost::uint64_t difference = (delta >> 1) ^ (~(delta & 1) + 1);
+        return T(boost::uint64_t(previous) + difference);
+    }
+
+    template<class T>
+    unsigned int DeltaCompressedColumn<T>::findBlock(TID tid) const {
+        // the first block ending behind tid contains it
+        return std::upper_bound(blockEnds.begin(), blockEnds.end(), tid) - blockEnds.begin();
+    }
+
+    template<class T>
+    TID DeltaCompressedColumn<T>::getBlockStart(unsigned int block) const {
+        return (block == 0) ? 0 : blockEnds[block - 1];
+    }
+
+    template<class T>
+    void DeltaCompressedColumn<T>::decodeBlock(unsigned int block) {
+        if(decodedBlockIndex == block && block < blockEnds.size()) {
+            return;
+        }
+        const BitPackedVector& deltas = blockDeltas[block];
+        decodedBlock.resize(deltas.size() + 1);
+        decodedBlock[0] = blockBases[block];
+        for(size_t i = 0; i < deltas.size(); i++) {
+            decodedBlock[i + 1] = decodeDelta(decodedBlock[i], deltas.get(i));
+        }
+        decodedBlockIndex = block;
+    }
+
+    template<class T>
+    void DeltaCompressedColumn<T>::encodeValues(const std::vector<T>& values, T& base, BitPackedVector& deltas) {
+        // a fresh vector shrinks the width in case the largest difference was removed
+        BitPackedVector encoded;
+        for(size_t i = 1; i < values.size(); i++) {
+            encoded.push_back(encodeDelta(values[i - 1], values[i]));
+        }
+        base = values[0];
+        std::swap(deltas, encoded);
+    }
+
+    template<class T>
+    void DeltaCompressedColumn<T>::encodeBlock(unsigned int block) {
+        encodeValues(decodedBlock, blockBases[block], blockDeltas[block]);
+    }
+
+    template<class T>
+    void DeltaCompressedColumn<T>::eraseBlock(unsigned int block) {
+        TID rows = blockEnds[block] - getBlockStart(block);
+        blockEnds.erase(blockEnds.begin() + block);
+        blockBases.erase(blockBases.begin() + block);
+        blockDeltas.erase(blockDeltas.begin() + block);
+        for(unsigned int i = block; i < blockEnds.size(); i++) {
+            blockEnds[i] -= rows;
+        }
+        decodedBlockIndex = blockEnds.size();
+    }
+
     template<class T>
     bool DeltaCompressedColumn<T>::insert(const boost::any&){
         // NOT NECESSARY FOR OUR PROGRAMMING TASK (NOT USED BY UNIT TEST).
@@ -71,27 +184,32 @@ public:
 
     template<class T>
     bool DeltaCompressedColumn<T>::insert(const T& new_value) {
-        if(deltaColumn.size() == 0) {
-            deltaColumn.push_back(new_value);
-        } else {
-            deltaColumn.push_back(new_value - this[deltaColumn.size() - 1]);
+        if(blockEnds.empty() || blockEnds.back() - getBlockStart(blockEnds.size() - 1) == DELTA_BLOCK_SIZE) {
+            // start a new block with the value as base
+            blockEnds.push_back(size() + 1);
+            blockBases.push_back(new_value);
+            blockDeltas.push_back(BitPackedVector());
+            decodedBlock.assign(1, new_value);
+            decodedBlockIndex = blockEnds.size() - 1;
+            return true;
         }
 
-//        } else {
-//            T lastEntry = deltaColumn[0];
-//            for(unsigned int i = 1; i < deltaColumn.size(); i++) {
-//                lastEntry += deltaColumn[i];
-//            }
-//            deltaColumn.push_back(new_value - lastEntry);
-//        }
+        // the cache holds the last block during a sequence of inserts
+        unsigned int last = blockEnds.size() - 1;
+        decodeBlock(last);
+        blockDeltas[last].push_back(encodeDelta(decodedBlock.back(), new_value));
+        decodedBlock.push_back(new_value);
+        blockEnds[last]++;
 
         return true;
     }
 
     template <typename T>
     template <typename InputIterator>
-    bool DeltaCompressedColumn<T>::insert(InputIterator, InputIterator){
-        // NOT NECESSARY FOR OUR PROGRAMMING TASK (NOT USED BY UNIT TEST).
+    bool DeltaCompressedColumn<T>::insert(InputIterator first, InputIterator last){
+        for(; first != last; ++first) {
+            insert(*first);
+        }
         return true;
     }
 
@@ -108,7 +226,10 @@ public:
 
     template<class T>
     size_t DeltaCompressedColumn<T>::size() const throw(){
-        return deltaColumn.size();
+        if(blockEnds.empty()) {
+            return 0;
+        }
+        return blockEnds.back();
     }
 
     template<class T>
@@ -118,80 +239,139 @@ public:
 
     template<class T>
     bool DeltaCompressedColumn<T>::update(TID tid, const boost::any& new_value){
-        if(tid >= deltaColumn.size()) {
+        if(tid >= size() || new_value.type() != typeid(T)) {
             return false;
         }
 
-        T delta = this[tid] - boost::any_cast<T>(new_value);
-        for(unsigned int i = tid; i < deltaColumn.size(); i++) {
-            deltaColumn[i] += delta;
-        }
+        unsigned int block = findBlock(tid);
+        decodeBlock(block);
+        decodedBlock[tid - getBlockStart(block)] = boost::any_cast<T>(new_value);
+        encodeBlock(block);
 
         return true;
     }
 
     template<class T>
-    bool DeltaCompressedColumn<T>::update(PositionListPtr, const boost::any&){
-        // NOT NECESSARY FOR OUR PROGRAMMING TASK (NOT USED BY UNIT TEST).
-        return false;
+    bool DeltaCompressedColumn<T>::update(PositionListPtr tids, const boost::any& new_value){
+        if(!tids || new_value.type() != typeid(T)) {
+            return false;
+        }
+
+        T value = boost::any_cast<T>(new_value);
+        PositionList sortedTids(*tids);
+        std::sort(sortedTids.begin(), sortedTids.end());
+        if(!sortedTids.empty() && sortedTids.back() >= size()) {
+            return false;
+        }
+
+        // every affected block is decoded and encoded once
+        unsigned int k = 0;
+        while(k < sortedTids.size()) {
+            unsigned int block = findBlock(sortedTids[k]);
+            decodeBlock(block);
+            TID start = getBlockStart(block);
+            for(; k < sortedTids.size() && sortedTids[k] < blockEnds[block]; k++) {
+                decodedBlock[sortedTids[k] - start] = value;
+            }
+            encodeBlock(block);
+        }
+
+        return true;
     }
 
     template<class T>
     bool DeltaCompressedColumn<T>::remove(TID tid){
-        if(tid >= deltaColumn.size()) {
+        if(tid >= size()) {
             return false;
         }
 
-        T delta = deltaColumn[tid];
-        deltaColumn.erase(deltaColumn.begin() + tid);
+        unsigned int block = findBlock(tid);
+        if(blockEnds[block] - getBlockStart(block) == 1) {
+            eraseBlock(block);
+            return true;
+        }
 
-        for(unsigned int i = tid; i < deltaColumn.size(); i++) {
-            deltaColumn[i] += delta;
+        decodeBlock(block);
+        decodedBlock.erase(decodedBlock.begin() + (tid - getBlockStart(block)));
+        encodeBlock(block);
+        for(unsigned int i = block; i < blockEnds.size(); i++) {
+            blockEnds[i]--;
         }
 
         return true;
     }
 
     template<class T>
-    bool DeltaCompressedColumn<T>::remove(PositionListPtr){
-        // NOT NECESSARY FOR OUR PROGRAMMING TASK (NOT USED BY UNIT TEST).
-        return false;
+    bool DeltaCompressedColumn<T>::remove(PositionListPtr tids){
+        if(!tids || tids->empty()) {
+            return false;
+        }
+
+        // Single pass over the blocks: every affected block is re-encoded once, empty blocks are dropped.
+        std::vector<TID> newEnds;
+        std::vector<T> newBases;
+        std::vector<BitPackedVector> newDeltas;
+        TID removedRows = 0;
+        unsigned int k = 0;
+        for(unsigned int block = 0; block < blockEnds.size(); block++) {
+            TID start = getBlockStart(block);
+            TID end = blockEnds[block];
+            if(k < tids->size() && (*tids)[k] < end) {
+                decodeBlock(block);
+                std::vector<T> remaining;
+                for(TID tid = start; tid < end; tid++) {
+                    if(k < tids->size() && (*tids)[k] == tid) {
+                        removedRows++;
+                        // skip duplicates
+                        while(k < tids->size() && (*tids)[k] == tid) {
+                            k++;
+                        }
+                    } else {
+                        remaining.push_back(decodedBlock[tid - start]);
+                    }
+                }
+                if(remaining.empty()) {
+                    continue;
+                }
+                newBases.push_back(T());
+                newDeltas.push_back(BitPackedVector());
+                encodeValues(remaining, newBases.back(), newDeltas.back());
+            } else {
+                newBases.push_back(blockBases[block]);
+                newDeltas.push_back(blockDeltas[block]);
+            }
+            newEnds.push_back(end - removedRows);
+        }
+
+        blockEnds.swap(newEnds);
+        blockBases.swap(newBases);
+        blockDeltas.swap(newDeltas);
+        decodedBlockIndex = blockEnds.size();
+        return true;
     }
 
     template<class T>
     bool DeltaCompressedColumn<T>::clearContent(){
-        deltaColumn.clear();
+        blockEnds.clear();
+        blockBases.clear();
+        blockDeltas.clear();
+        decodedBlock.clear();
+        decodedBlockIndex = 0;
         return true;
     }
 
     template<class T>
     bool DeltaCompressedColumn<T>::store(const std::string& path_){
-        // Recreate normal/standard column form?
-
         std::string path(path_);
         path += _name;
 
-//        std::cout << "Writing Column '" << _name << "' to File '" << path << "'" << std::endl;
-
         std::ofstream outfile (path.c_str(), std::fstream::out | std::fstream::binary);
         boost::archive::binary_oarchive oa(outfile);
 
-//        oa << columnEntries;
-
-        // REMAPS TO THE INITIAL VALUES. PLACEHOLDER UNTIL REAL REQUIREMENTS FOR THIS METHOD ARE CLEAR TO US.
-        std::vector<T> simpleColumnRepresentation;
-        for(unsigned int i = 0; i < deltaColumn.size(); i++) {
-            simpleColumnRepresentation.push_back(this[i]);
-        }
-        oa << simpleColumnRepresentation;
-
+        oa << blockEnds << blockBases << blockDeltas;
         outfile.flush();
         outfile.close();
 
-//        for(unsigned int i = 0; i < simpleColumnRepresentation.size(); i++) {
-//            std::cout << "Column entry[" << i << "]: " << simpleColumnRepresentation[i] << std::endl;
-//        }
-
         return true;
     }
 
@@ -203,26 +383,74 @@ public:
         std::ifstream infile (path.c_str(), std::fstream::in | std::fstream::binary);
         boost::archive::binary_iarchive ia(infile);
 
-//        ia >> columnEntries;
-
+        ia >> blockEnds >> blockBases >> blockDeltas;
         infile.close();
 
+        decodedBlock.clear();
+        decodedBlockIndex = blockEnds.size();
+        return true;
+    }
+
+    template<class T>
+    bool DeltaCompressedColumn<T>::supportsConcurrentReads() const throw(){
+        // the decoded block is cached by operator[]
+        return false;
+    }
+
+    template<class T>
+    bool DeltaCompressedColumn<T>::applyOperation(ColumnAlgebraOperation op, const T& operand){
+        if(op == ADD || op == SUB) {
+            if(!blockBases.empty()) {
+                apply_operation(&blockBases[0], blockBases.size(), op, operand);
+            }
+            decodedBlockIndex = blockEnds.size();
+            return true;
+        }
+        for(unsigned int block = 0; block < blockEnds.size(); block++) {
+            decodeBlock(block);
+            apply_operation(&decodedBlock[0], decodedBlock.size(), op, operand);
+            encodeBlock(block);
+        }
         return true;
     }
 
     template<class T>
     T& DeltaCompressedColumn<T>::operator[](const int index){
-        T entry = deltaColumn[0];
-        for(int i = 1; i <= index; i++) {
-            entry += deltaColumn[i];
+        // The reference points into the block cache, it stays valid until another block is accessed.
+        TID tid = index;
+        if(decodedBlockIndex >= blockEnds.size() || tid < getBlockStart(decodedBlockIndex) || tid >= blockEnds[decodedBlockIndex]) {
+            decodeBlock(findBlock(tid));
+        }
+        return decodedBlock[tid - getBlockStart(decodedBlockIndex)];
+    }
+
+    template<class T>
+    void DeltaCompressedColumn<T>::decode(TID begin, TID end, T* out){
+        for(unsigned int block = findBlock(begin); begin < end; block++) {
+            decodeBlock(block);
+            TID blockStart = getBlockStart(block);
+            TID blockEnd = std::min(blockEnds[block], end);
+            out = std::copy(decodedBlock.begin() + (begin - blockStart), decodedBlock.begin() + (blockEnd - blockStart), out);
+            begin = blockEnd;
+        }
+    }
+
+    template<class T>
+    void DeltaCompressedColumn<T>::gather(const TID* tids, size_t count, T* out){
+        // consecutive TIDs of the same block are served from the block cache, without a virtual call per row
+        for(size_t i = 0; i < count; i++) {
+            out[i] = DeltaCompressedColumn<T>::operator[](tids[i]);
         }
-        return entry;
     }
 
     template<class T>
     unsigned int DeltaCompressedColumn<T>::getSizeinBytes() const throw(){
-        // What shall be returned? Size of columnEntries and dictionary?
-        return deltaColumn.capacity() * sizeof(T);
+        unsigned int size = blockEnds.capacity() * sizeof(TID);
+        size += blockBases.capacity() * sizeof(T);
+        for(unsigned int i = 0; i < blockDeltas.size(); i++) {
+            size += blockDeltas[i].getSizeinBytes();
+        }
+        return size;
     }
 
 /***************** End of Implementation Section ******************/
@@ -230,4 +458,3 @@ public:
 
 
 }; //end namespace CogaDB
-
@@ -6,19 +6,32 @@
 #pragma once
 
 #include <core/compressed_column.hpp>
-#include <boost/serialization/map.hpp>
+#include <core/bit_packed_vector.hpp>
+#include <boost/unordered_map.hpp>
+#include <algorithm>
 
 namespace CoGaDB{
 
 
+
 /*!
  *  \brief     This class represents a dictionary compressed column with type T, is the base class for all compressed typed column classes.
+ *  \details   Every distinct value gets a code, which is its index in the dictionary. A hash map from value to code makes encoding a
+ *             value O(1), so the column can be loaded in linear time. The codes are bit packed with ceil(log2(dictionary size)) bits
+ *             each and decoded block wise with the SIMD unpack kernels during scans.
+ *             In order preserving mode, the dictionary is kept sorted, so the order of the codes equals the order of the values.
+ *             Range predicates are then evaluated on the codes only. New values that break the order are appended and the
+ *             dictionary is rebuilt (sorted and renumbered) before the next selection.
+ *             Without a sorted dictionary, a selection evaluates the predicate once per dictionary entry and then scans the codes:
+ *             an equality predicate compares against a single code, range predicates look up each code in a table of matching codes.
+ *             parallel_selection() scans morsels of the codes with the same code space predicate in parallel.
+ *             sort() only sorts the distinct values and then orders the rows by a counting sort over the ranks of their codes.
  */
 template<class T>
 class DictionaryCompressedColumn : public CompressedColumn<T>{
 public:
     /***************** constructors and destructor *****************/
-    DictionaryCompressedColumn(const std::string& name, AttributeType db_type);
+    DictionaryCompressedColumn(const std::string& name, AttributeType db_type, bool orderPreserving = false);
     virtual ~DictionaryCompressedColumn();
 
     virtual bool insert(const boost::any& new_Value);
@@ -45,23 +58,60 @@ public:
     virtual bool store(const std::string& path);
     virtual bool load(const std::string& path);
 
-
+    virtual const PositionListPtr sort(SortOrder order);
+    virtual const PositionListPtr selection(const boost::any& value_for_comparison, const ValueComparator comp);
+    virtual const PositionListPtr parallel_selection(const boost::any& value_for_comparison, const ValueComparator comp, unsigned int number_of_threads);
 
     virtual T& operator[](const int index);
-
-    /*! values*/
-    std::map<char, T> dictionary;
-    std::vector<char> columnEntries;
+    /*! unpacks blocks of codes with the SIMD kernels and looks them up in the dictionary*/
+    virtual void decode(TID begin, TID end, T* out);
+    virtual void gather(const TID* tids, size_t count, T* out);
+
+    /*! sorts the dictionary, renumbers all codes and drops values no row refers to, equal values get a single code*/
+    void rebuildDictionary();
+
+    /*! distinct values, the code of a value is its index*/
+    std::vector<T> dictionary;
+    /*! maps each distinct value to its code*/
+    boost::unordered_map<T, unsigned int> reverseDictionary;
+    /*! code of each row*/
+    BitPackedVector columnEntries;
     std::string _name;
+    /*! true in case the dictionary is kept sorted by rebuildDictionary()*/
+    bool orderPreserving;
+    /*! true in case the dictionary is currently sorted ascending, i.e., codes compare like their values*/
+    bool dictionarySorted;
+
+protected:
+    /*! computes the new distinct values only, the codes are only renumbered in case values became equal or out of order*/
+    virtual bool applyOperation(ColumnAlgebraOperation op, const T& operand);
+
+private:
+    /*! returns the code of value, unknown values are added to the dictionary*/
+    unsigned int encode(const T& value);
+    /*! a predicate in code space: the codes in [lowerCode, upperCode), or the codes marked in isMatchingCode in case it is not empty*/
+    struct CodePredicate{
+        CodePredicate() : lowerCode(0), upperCode(0), isMatchingCode() {}
+        unsigned int lowerCode;
+        unsigned int upperCode;
+        std::vector<char> isMatchingCode;
+    };
+    /*! translates a selection into predicate, returns false in case no code can match*/
+    bool getCodePredicate(const boost::any& value_for_comparison, const ValueComparator comp, CodePredicate& predicate);
+    /*! appends the positions of all rows in [begin, end) whose code fulfills predicate to result*/
+    void findCodes(const CodePredicate& predicate, TID begin, TID end, PositionList& result) const;
+
+    /*! number of codes that are unpacked at once during a scan*/
+    static const unsigned int SCAN_BLOCK_SIZE = 1024;
 
 };
 
 
 /***************** Start of Implementation Section ******************/
 
-
     template<class T>
-    DictionaryCompressedColumn<T>::DictionaryCompressedColumn(const std::string& name, AttributeType db_type) : CompressedColumn<T>(name, db_type), dictionary(), columnEntries(), _name(name) {
+    DictionaryCompressedColumn<T>::DictionaryCompressedColumn(const std::string& name, AttributeType db_type, bool orderPreserving)
+        : CompressedColumn<T>(name, db_type), dictionary(), reverseDictionary(), columnEntries(), _name(name), orderPreserving(orderPreserving), dictionarySorted(true) {
 
     }
 
@@ -77,24 +127,37 @@ public:
     }
 
     template<class T>
-    bool DictionaryCompressedColumn<T>::insert(const T& new_value) {
-        for(unsigned int i = 0; i < columnEntries.size(); i++) {
-            if(dictionary.at(columnEntries[i]) == new_value) {
-                columnEntries.push_back(columnEntries[i]);
-                return true;
-            }
+    unsigned int DictionaryCompressedColumn<T>::encode(const T& value) {
+        typename boost::unordered_map<T, unsigned int>::const_iterator it = reverseDictionary.find(value);
+        if(it != reverseDictionary.end()) {
+            return it->second;
         }
 
-        columnEntries.push_back(dictionary.size());
-        dictionary.insert(std::pair<char, T>(dictionary.size(), new_value));
+        unsigned int code = dictionary.size();
+        if(!dictionary.empty() && !(dictionary.back() < value)) {
+            dictionarySorted = false;
+        }
+        dictionary.push_back(value);
+        reverseDictionary.insert(std::make_pair(value, code));
+        return code;
+    }
 
+    template<class T>
+    bool DictionaryCompressedColumn<T>::insert(const T& new_value) {
+        columnEntries.push_back(encode(new_value));
         return true;
     }
 
     template <typename T>
     template <typename InputIterator>
-    bool DictionaryCompressedColumn<T>::insert(InputIterator, InputIterator){
-        // NOT NECESSARY FOR OUR PROGRAMMING TASK (NOT USED BY UNIT TEST).
+    bool DictionaryCompressedColumn<T>::insert(InputIterator first, InputIterator last){
+        for(; first != last; ++first) {
+            columnEntries.push_back(encode(*first));
+        }
+        // renumber once for the whole batch instead of keeping the order on every new value
+        if(orderPreserving && !dictionarySorted) {
+            rebuildDictionary();
+        }
         return true;
     }
 
@@ -125,15 +188,7 @@ public:
             return false;
         }
 
-        for(unsigned int i = 0; i < columnEntries.size(); i++) {
-            if(dictionary.at(columnEntries[i]) == boost::any_cast<T>(new_value)) {
-                columnEntries[tid] = columnEntries[i];
-                return true;
-            }
-        }
-
-        columnEntries[tid] = dictionary.size();
-        dictionary.insert(std::pair<char, T>(dictionary.size(), boost::any_cast<T>(new_value)));
+        columnEntries.set(tid, encode(boost::any_cast<T>(new_value)));
         return true;
     }
 
@@ -149,7 +204,7 @@ public:
             return false;
         }
 
-        columnEntries.erase(columnEntries.begin() + tid);
+        columnEntries.erase(tid);
         return true;
     }
 
@@ -162,6 +217,9 @@ public:
     template<class T>
     bool DictionaryCompressedColumn<T>::clearContent(){
         columnEntries.clear();
+        dictionary.clear();
+        reverseDictionary.clear();
+        dictionarySorted = true;
         return true;
     }
 
@@ -191,19 +249,251 @@ public:
         ia >> columnEntries >> dictionary;
         infile.close();
 
+        reverseDictionary.clear();
+        dictionarySorted = true;
+        for(unsigned int i = 0; i < dictionary.size(); i++) {
+            reverseDictionary.insert(std::make_pair(dictionary[i], i));
+            if(i > 0 && !(dictionary[i - 1] < dictionary[i])) {
+                dictionarySorted = false;
+            }
+        }
+
         return true;
     }
 
+    template<class T>
+    void DictionaryCompressedColumn<T>::rebuildDictionary(){
+        std::vector<bool> isUsed(dictionary.size(), false);
+        for(unsigned int i = 0; i < columnEntries.size(); i++) {
+            isUsed[columnEntries.get(i)] = true;
+        }
+
+        std::vector<T> sortedDictionary;
+        for(unsigned int code = 0; code < dictionary.size(); code++) {
+            if(isUsed[code]) {
+                sortedDictionary.push_back(dictionary[code]);
+            }
+        }
+        std::sort(sortedDictionary.begin(), sortedDictionary.end());
+        sortedDictionary.erase(std::unique(sortedDictionary.begin(), sortedDictionary.end()), sortedDictionary.end());
+
+        // the new code of a value is its position in the sorted dictionary
+        std::vector<unsigned int> newCodes(dictionary.size(), 0);
+        for(unsigned int code = 0; code < dictionary.size(); code++) {
+            if(isUsed[code]) {
+                newCodes[code] = std::lower_bound(sortedDictionary.begin(), sortedDictionary.end(), dictionary[code]) - sortedDictionary.begin();
+            }
+        }
+
+        BitPackedVector newColumnEntries(BitPackedVector::bitsRequired(sortedDictionary.empty() ? 0 : sortedDictionary.size() - 1));
+        for(unsigned int i = 0; i < columnEntries.size(); i++) {
+            newColumnEntries.push_back(newCodes[columnEntries.get(i)]);
+        }
+
+        columnEntries = newColumnEntries;
+        dictionary.swap(sortedDictionary);
+        reverseDictionary.clear();
+        for(unsigned int code = 0; code < dictionary.size(); code++) {
+            reverseDictionary.insert(std::make_pair(dictionary[code], code));
+        }
+        dictionarySorted = true;
+    }
+
+    template<class T>
+    bool DictionaryCompressedColumn<T>::applyOperation(ColumnAlgebraOperation op, const T& operand){
+        if(dictionary.empty()) {
+            return true;
+        }
+        apply_operation(&dictionary[0], dictionary.size(), op, operand);
+
+        bool isInjective = true;
+        dictionarySorted = true;
+        reverseDictionary.clear();
+        for(unsigned int code = 0; code < dictionary.size(); code++) {
+            isInjective = reverseDictionary.insert(std::make_pair(dictionary[code], code)).second && isInjective;
+            if(code > 0 && !(dictionary[code - 1] < dictionary[code])) {
+                dictionarySorted = false;
+            }
+        }
+        // values that became equal (e.g., by an integer division) have to share a code, a negative factor reverses the order
+        if(!isInjective || (orderPreserving && !dictionarySorted)) {
+            rebuildDictionary();
+        }
+        return true;
+    }
+
+    /*! \brief orders codes by the values they represent*/
+    template<class T>
+    struct DictionaryCodeLess{
+        explicit DictionaryCodeLess(const std::vector<T>& dictionary) : dictionary(dictionary) {}
+        bool operator()(unsigned int a, unsigned int b) const { return dictionary[a] < dictionary[b]; }
+        const std::vector<T>& dictionary;
+    };
+
+    template<class T>
+    const PositionListPtr DictionaryCompressedColumn<T>::sort(SortOrder order){
+        if(order != ASCENDING && order != DESCENDING) {
+            return ColumnBaseTyped<T>::sort(order);
+        }
+
+        // rank of each code in the sort order, sorting the distinct values costs O(d log d) only
+        std::vector<unsigned int> codesByValue(dictionary.size());
+        for(unsigned int code = 0; code < dictionary.size(); code++) {
+            codesByValue[code] = code;
+        }
+        if(!dictionarySorted) {
+            std::sort(codesByValue.begin(), codesByValue.end(), DictionaryCodeLess<T>(dictionary));
+        }
+        std::vector<size_t> rankOffsets(dictionary.size() + 1, 0);
+        std::vector<unsigned int> ranks(dictionary.size());
+        for(unsigned int i = 0; i < codesByValue.size(); i++) {
+            ranks[codesByValue[i]] = (order == ASCENDING) ? i : codesByValue.size() - 1 - i;
+        }
+
+        // counting sort of the rows by the rank of their code, rows with equal values keep their TID order
+        boost::uint32_t codes[SCAN_BLOCK_SIZE];
+        for(TID begin = 0; begin < columnEntries.size(); begin += SCAN_BLOCK_SIZE) {
+            unsigned int count = std::min<size_t>(SCAN_BLOCK_SIZE, columnEntries.size() - begin);
+            columnEntries.unpack(begin, count, codes);
+            for(unsigned int i = 0; i < count; i++) {
+                rankOffsets[ranks[codes[i]] + 1]++;
+            }
+        }
+        for(unsigned int rank = 0; rank < dictionary.size(); rank++) {
+            rankOffsets[rank + 1] += rankOffsets[rank];
+        }
+
+        PositionListPtr ids(new PositionList(columnEntries.size()));
+        for(TID begin = 0; begin < columnEntries.size(); begin += SCAN_BLOCK_SIZE) {
+            unsigned int count = std::min<size_t>(SCAN_BLOCK_SIZE, columnEntries.size() - begin);
+            columnEntries.unpack(begin, count, codes);
+            for(unsigned int i = 0; i < count; i++) {
+                (*ids)[rankOffsets[ranks[codes[i]]]++] = begin + i;
+            }
+        }
+        return ids;
+    }
+
+    template<class T>
+    bool DictionaryCompressedColumn<T>::getCodePredicate(const boost::any& value_for_comparison, const ValueComparator comp, CodePredicate& predicate){
+        if(orderPreserving && !dictionarySorted) {
+            rebuildDictionary();
+        }
+        if(value_for_comparison.type() != typeid(T)) {
+            std::cout << "Fatal Error!!! Typemismatch for column " << this->name_ << std::endl;
+            std::cout << "File: " << __FILE__ << " Line: " << __LINE__ << std::endl;
+            exit(-1);
+        }
+        T value = boost::any_cast<T>(value_for_comparison);
+
+        if(!dictionarySorted) {
+            if(comp == EQUAL) {
+                // values missing from the dictionary match no row
+                typename boost::unordered_map<T, unsigned int>::const_iterator it = reverseDictionary.find(value);
+                if(it == reverseDictionary.end()) {
+                    return false;
+                }
+                predicate.lowerCode = it->second;
+                predicate.upperCode = it->second + 1;
+                return true;
+            }
+            predicate.isMatchingCode.assign(dictionary.size(), 0);
+            bool anyMatch = false;
+            for(unsigned int code = 0; code < dictionary.size(); code++) {
+                predicate.isMatchingCode[code] = (comp == LESSER) ? dictionary[code] < value : dictionary[code] > value;
+                anyMatch = anyMatch || predicate.isMatchingCode[code];
+            }
+            return anyMatch;
+        }
+
+        // the codes of all values equal to value lie in [lower_code, upper_code), which is empty for unknown values
+        unsigned int lowerCode = std::lower_bound(dictionary.begin(), dictionary.end(), value) - dictionary.begin();
+        unsigned int upperCode = std::upper_bound(dictionary.begin(), dictionary.end(), value) - dictionary.begin();
+        if(comp == EQUAL) {
+            predicate.lowerCode = lowerCode;
+            predicate.upperCode = upperCode;
+        } else if(comp == LESSER) {
+            predicate.lowerCode = 0;
+            predicate.upperCode = lowerCode;
+        } else {
+            predicate.lowerCode = upperCode;
+            predicate.upperCode = dictionary.size();
+        }
+        return predicate.lowerCode < predicate.upperCode;
+    }
+
+    template<class T>
+    const PositionListPtr DictionaryCompressedColumn<T>::selection(const boost::any& value_for_comparison, const ValueComparator comp){
+        CodePredicate predicate;
+        PositionListPtr result_tids(new PositionList());
+        if(getCodePredicate(value_for_comparison, comp, predicate)) {
+            findCodes(predicate, 0, columnEntries.size(), *result_tids);
+        }
+        return result_tids;
+    }
+
+    template<class T>
+    const PositionListPtr DictionaryCompressedColumn<T>::parallel_selection(const boost::any& value_for_comparison, const ValueComparator comp, unsigned int number_of_threads){
+        CodePredicate predicate;
+        if(!getCodePredicate(value_for_comparison, comp, predicate)) {
+            return PositionListPtr(new PositionList());
+        }
+        if(number_of_threads <= 1 || columnEntries.size() <= MORSEL_SIZE) {
+            PositionListPtr result_tids(new PositionList());
+            findCodes(predicate, 0, columnEntries.size(), *result_tids);
+            return result_tids;
+        }
+        return parallel_scan(columnEntries.size(), number_of_threads,
+            boost::bind(&DictionaryCompressedColumn<T>::findCodes, this, boost::cref(predicate), boost::placeholders::_1, boost::placeholders::_2, boost::placeholders::_3));
+    }
+
+    template<class T>
+    void DictionaryCompressedColumn<T>::findCodes(const CodePredicate& predicate, TID begin, TID end, PositionList& result) const{
+        boost::uint32_t codes[SCAN_BLOCK_SIZE];
+        for(TID first = begin; first < end; first += SCAN_BLOCK_SIZE) {
+            unsigned int count = std::min<size_t>(SCAN_BLOCK_SIZE, end - first);
+            columnEntries.unpack(first, count, codes);
+            if(predicate.isMatchingCode.empty()) {
+                find_in_range(codes, count, predicate.lowerCode, predicate.upperCode, first, result);
+            } else {
+                for(unsigned int i = 0; i < count; i++) {
+                    if(predicate.isMatchingCode[codes[i]]) {
+                        result.push_back(first + i);
+                    }
+                }
+            }
+        }
+    }
+
     template<class T>
     T& DictionaryCompressedColumn<T>::operator[](const int index){
-        char key = columnEntries[index];
-        return dictionary.at(key);
+        return dictionary[columnEntries.get(index)];
+    }
+
+    template<class T>
+    void DictionaryCompressedColumn<T>::decode(TID begin, TID end, T* out){
+        boost::uint32_t codes[SCAN_BLOCK_SIZE];
+        for(TID first = begin; first < end; first += SCAN_BLOCK_SIZE) {
+            unsigned int count = std::min<size_t>(SCAN_BLOCK_SIZE, end - first);
+            columnEntries.unpack(first, count, codes);
+            for(unsigned int i = 0; i < count; i++) {
+                *out++ = dictionary[codes[i]];
+            }
+        }
+    }
+
+    template<class T>
+    void DictionaryCompressedColumn<T>::gather(const TID* tids, size_t count, T* out){
+        for(size_t i = 0; i < count; i++) {
+            out[i] = dictionary[columnEntries.get(tids[i])];
+        }
     }
 
     template<class T>
     unsigned int DictionaryCompressedColumn<T>::getSizeinBytes() const throw(){
-        int size = columnEntries.capacity() * sizeof(char);
-        size += dictionary.size() * (sizeof(char) + sizeof(T));
+        unsigned int size = columnEntries.getSizeinBytes();
+        size += dictionary.capacity() * sizeof(T);
+        size += reverseDictionary.size() * (sizeof(T) + sizeof(unsigned int));
         return size;
     }
 
@@ -0,0 +1,568 @@
+#pragma once
+
+#include <core/compressed_column.hpp>
+#include <core/bit_packed_vector.hpp>
+#include <boost/unordered_map.hpp>
+#include <boost/serialization/utility.hpp>
+#include <algorithm>
+
+namespace CoGaDB{
+
+/*! \brief number of frequency tiers of a frequency partitioned column*/
+const unsigned int FREQUENCY_TIERS = 4;
+
+/*!
+ *  \brief     This class represents a frequency partitioned column with type T, is the base class for all compressed typed column classes.
+ *  \details   The distinct values are ranked by frequency and split into FREQUENCY_TIERS tiers. Every tier has its own dictionary
+ *             and a fixed code width, so the hottest values get the shortest codes. The capacities of the tiers are chosen to
+ *             minimize the total number of code bits. Every row stores its tier id (2 bits) and its code in the code vector of its
+ *             tier. A rank directory stores the number of rows per tier in front of every block of RANK_BLOCK_SIZE rows, which
+ *             maps a row to its position in the code vector of its tier. Values that are unknown at insertion time are added to
+ *             the last tier, the tiers are recomputed whenever the column has doubled in size since the last partitioning.
+ */
+template<class T>
+class FrequencyPartitionedColumn : public CompressedColumn<T>{
+public:
+    /***************** constructors and destructor *****************/
+    FrequencyPartitionedColumn(const std::string& name, AttributeType db_type);
+    virtual ~FrequencyPartitionedColumn();
+
+    virtual bool insert(const boost::any& new_Value);
+    virtual bool insert(const T& new_value);
+    template <typename InputIterator>
+    bool insert(InputIterator first, InputIterator last);
+
+    virtual bool update(TID tid, const boost::any& new_value);
+    virtual bool update(PositionListPtr tid, const boost::any& new_value);
+
+    virtual bool remove(TID tid);
+    //assumes tid list is sorted ascending
+    virtual bool remove(PositionListPtr tid);
+    virtual bool clearContent();
+
+    virtual const boost::any get(TID tid);
+    //virtual const boost::any* const getRawData()=0;
+    virtual void print() const throw();
+    virtual size_t size() const throw();
+    virtual unsigned int getSizeinBytes() const throw();
+
+    virtual const ColumnPtr copy() const;
+
+    virtual bool store(const std::string& path);
+    virtual bool load(const std::string& path);
+
+
+
+    virtual T& operator[](const int index);
+    /*! walks the rows once with local tier ranks, starting at the rank directory entry in front of begin*/
+    virtual void decode(TID begin, TID end, T* out);
+    virtual bool supportsConcurrentReads() const throw();
+
+    /*! ranks the distinct values by frequency, recomputes the tiers and encodes all rows again, unused values are dropped*/
+    void repartition();
+
+    /*! tier of each row*/
+    BitPackedVector tierIds;
+    /*! codes of the rows of each tier, in row order*/
+    std::vector<BitPackedVector> tierCodes;
+    /*! distinct values of each tier, the code of a value is its index*/
+    std::vector<std::vector<T> > tierDictionaries;
+    /*! maps each distinct value to its tier and code*/
+    boost::unordered_map<T, std::pair<unsigned int, unsigned int> > valueCodes;
+    std::string _name;
+
+protected:
+    /*! computes the new values of the tier dictionaries only, in case values become equal the rows are encoded again*/
+    virtual bool applyOperation(ColumnAlgebraOperation op, const T& operand);
+
+private:
+    /*! returns the tier and code of value, unknown values are added to the last tier*/
+    std::pair<unsigned int, unsigned int> encode(const T& value);
+    /*! returns the number of rows in front of tid that belong to tier*/
+    TID rank(TID tid, unsigned int tier) const;
+    void rebuildRankDirectory();
+    void rebuildValueCodes();
+    /*! returns the end rank of the first FREQUENCY_TIERS-1 tiers with the least code bits for distinct values with the
+     *  given frequencies (sorted descending)*/
+    static std::vector<TID> chooseTierEnds(const std::vector<TID>& frequencies);
+
+    /*! number of rows per entry of the rank directory*/
+    static const unsigned int RANK_BLOCK_SIZE = 64;
+    /*! the column is partitioned the first time it reaches this number of rows*/
+    static const unsigned int REPARTITION_MIN_ROWS = 64;
+    /*! largest code width of the first FREQUENCY_TIERS-1 tiers*/
+    static const unsigned int MAX_TIER_BITS = 16;
+
+    /*! number of rows of each tier in front of every block of RANK_BLOCK_SIZE rows*/
+    std::vector<TID> rankDirectory;
+    /*! position of the last access and the number of rows of each tier in front of it, which makes sequential access O(1)*/
+    TID cursorTid;
+    std::vector<TID> cursorRanks;
+    /*! number of rows at the last partitioning*/
+    TID partitionedRows;
+
+};
+
+
+/***************** Start of Implementation Section ******************/
+
+
+    template<class T>
+    FrequencyPartitionedColumn<T>::FrequencyPartitionedColumn(const std::string& name, AttributeType db_type)
+        : CompressedColumn<T>(name, db_type), tierIds(BitPackedVector::bitsRequired(FREQUENCY_TIERS - 1)), tierCodes(FREQUENCY_TIERS),
+          tierDictionaries(FREQUENCY_TIERS), valueCodes(), _name(name), rankDirectory(), cursorTid(0), cursorRanks(), partitionedRows(0) {
+
+    }
+
+    template<class T>
+    FrequencyPartitionedColumn<T>::~FrequencyPartitionedColumn(){
+
+    }
+
+    template<class T>
+    bool FrequencyPartitionedColumn<T>::insert(const boost::any&){
+        // NOT NECESSARY FOR OUR PROGRAMMING TASK (NOT USED BY UNIT TEST).
+        return false;
+    }
+
+    template<class T>
+    std::pair<unsigned int, unsigned int> FrequencyPartitionedColumn<T>::encode(const T& value) {
+        typename boost::unordered_map<T, std::pair<unsigned int, unsigned int> >::const_iterator it = valueCodes.find(value);
+        if(it != valueCodes.end()) {
+            return it->second;
+        }
+
+        std::pair<unsigned int, unsigned int> code(FREQUENCY_TIERS - 1, tierDictionaries[FREQUENCY_TIERS - 1].size());
+        tierDictionaries[FREQUENCY_TIERS - 1].push_back(value);
+        valueCodes.insert(std::make_pair(value, code));
+        return code;
+    }
+
+    template<class T>
+    TID FrequencyPartitionedColumn<T>::rank(TID tid, unsigned int tier) const {
+        TID block = tid / RANK_BLOCK_SIZE;
+        TID result = rankDirectory[block * FREQUENCY_TIERS + tier];
+        for(TID i = block * RANK_BLOCK_SIZE; i < tid; i++) {
+            if(tierIds.get(i) == tier) {
+                result++;
+            }
+        }
+        return result;
+    }
+
+    template<class T>
+    void FrequencyPartitionedColumn<T>::rebuildRankDirectory() {
+        rankDirectory.clear();
+        std::vector<TID> counters(FREQUENCY_TIERS, 0);
+        for(TID i = 0; i < tierIds.size(); i++) {
+            if(i % RANK_BLOCK_SIZE == 0) {
+                rankDirectory.insert(rankDirectory.end(), counters.begin(), counters.end());
+            }
+            counters[tierIds.get(i)]++;
+        }
+        cursorRanks.clear();
+    }
+
+    template<class T>
+    void FrequencyPartitionedColumn<T>::rebuildValueCodes() {
+        valueCodes.clear();
+        for(unsigned int tier = 0; tier < FREQUENCY_TIERS; tier++) {
+            for(unsigned int code = 0; code < tierDictionaries[tier].size(); code++) {
+                valueCodes.insert(std::make_pair(tierDictionaries[tier][code], std::make_pair(tier, code)));
+            }
+        }
+    }
+
+    template<class T>
+    std::vector<TID> FrequencyPartitionedColumn<T>::chooseTierEnds(const std::vector<TID>& frequencies) {
+        const TID distinctValues = frequencies.size();
+        std::vector<boost::uint64_t> prefixSums(distinctValues + 1, 0);
+        for(TID i = 0; i < distinctValues; i++) {
+            prefixSums[i + 1] = prefixSums[i] + frequencies[i];
+        }
+
+        // every tier is either empty or holds 2^width values, the last tier takes the remaining values
+        std::vector<TID> capacities(1, 0);
+        for(unsigned int width = 0; width <= MAX_TIER_BITS; width++) {
+            capacities.push_back(TID(1) << width);
+        }
+
+        std::vector<TID> best(FREQUENCY_TIERS - 1, 0);
+        boost::uint64_t bestCost = ~boost::uint64_t(0);
+        for(unsigned int a = 0; a < capacities.size(); a++) {
+            TID end0 = std::min(capacities[a], distinctValues);
+            for(unsigned int b = 0; b < capacities.size(); b++) {
+                TID end1 = std::min(end0 + capacities[b], distinctValues);
+                for(unsigned int c = 0; c < capacities.size(); c++) {
+                    TID end2 = std::min(end1 + capacities[c], distinctValues);
+                    unsigned int lastWidth = (end2 < distinctValues) ? BitPackedVector::bitsRequired(distinctValues - end2 - 1) : 0;
+                    // capacity 2^width has code width width, an empty tier contributes no rows
+                    boost::uint64_t cost = prefixSums[end0] * (a > 0 ? a - 1 : 0)
+                                         + (prefixSums[end1] - prefixSums[end0]) * (b > 0 ? b - 1 : 0)
+                                         + (prefixSums[end2] - prefixSums[end1]) * (c > 0 ? c - 1 : 0)
+                                         + (prefixSums[distinctValues] - prefixSums[end2]) * lastWidth;
+                    if(cost < bestCost) {
+                        bestCost = cost;
+                        best[0] = end0;
+                        best[1] = end1;
+                        best[2] = end2;
+                    }
+                }
+            }
+        }
+        return best;
+    }
+
+    template<class T>
+    void FrequencyPartitionedColumn<T>::repartition() {
+        // count the rows of every distinct value
+        std::vector<std::vector<TID> > frequencies(FREQUENCY_TIERS);
+        for(unsigned int tier = 0; tier < FREQUENCY_TIERS; tier++) {
+            frequencies[tier].assign(tierDictionaries[tier].size(), 0);
+            for(TID i = 0; i < tierCodes[tier].size(); i++) {
+                frequencies[tier][tierCodes[tier].get(i)]++;
+            }
+        }
+
+        // rank the values by frequency, unused values are dropped
+        std::vector<std::pair<TID, std::pair<unsigned int, unsigned int> > > ranking;
+        for(unsigned int tier = 0; tier < FREQUENCY_TIERS; tier++) {
+            for(unsigned int code = 0; code < frequencies[tier].size(); code++) {
+                if(frequencies[tier][code] > 0) {
+                    // negated frequencies sort the most frequent value first
+                    ranking.push_back(std::make_pair(TID(0) - frequencies[tier][code], std::make_pair(tier, code)));
+                }
+            }
+        }
+        std::sort(ranking.begin(), ranking.end());
+        std::vector<TID> sortedFrequencies(ranking.size());
+        for(TID i = 0; i < ranking.size(); i++) {
+            sortedFrequencies[i] = TID(0) - ranking[i].first;
+        }
+        std::vector<TID> tierEnds = chooseTierEnds(sortedFrequencies);
+        tierEnds.push_back(ranking.size());
+
+        // assign the new tiers and codes
+        std::vector<std::vector<T> > newDictionaries(FREQUENCY_TIERS);
+        std::vector<std::vector<std::pair<unsigned int, unsigned int> > > newCodes(FREQUENCY_TIERS);
+        for(unsigned int tier = 0; tier < FREQUENCY_TIERS; tier++) {
+            newCodes[tier].resize(tierDictionaries[tier].size());
+        }
+        unsigned int newTier = 0;
+        for(TID i = 0; i < ranking.size(); i++) {
+            while(i >= tierEnds[newTier]) {
+                newTier++;
+            }
+            const std::pair<unsigned int, unsigned int>& old = ranking[i].second;
+            newCodes[old.first][old.second] = std::make_pair(newTier, newDictionaries[newTier].size());
+            newDictionaries[newTier].push_back(tierDictionaries[old.first][old.second]);
+        }
+
+        // encode all rows again
+        BitPackedVector newTierIds(tierIds.getBitsPerValue());
+        std::vector<BitPackedVector> newTierCodes;
+        for(unsigned int tier = 0; tier < FREQUENCY_TIERS; tier++) {
+            newTierCodes.push_back(BitPackedVector(newDictionaries[tier].size() > 1 ? BitPackedVector::bitsRequired(newDictionaries[tier].size() - 1) : 0));
+        }
+        std::vector<TID> counters(FREQUENCY_TIERS, 0);
+        for(TID i = 0; i < tierIds.size(); i++) {
+            unsigned int tier = tierIds.get(i);
+            const std::pair<unsigned int, unsigned int>& code = newCodes[tier][tierCodes[tier].get(counters[tier]++)];
+            newTierIds.push_back(code.first);
+            newTierCodes[code.first].push_back(code.second);
+        }
+
+        std::swap(tierIds, newTierIds);
+        tierCodes.swap(newTierCodes);
+        tierDictionaries.swap(newDictionaries);
+        rebuildValueCodes();
+        rebuildRankDirectory();
+        partitionedRows = size();
+    }
+
+    template<class T>
+    bool FrequencyPartitionedColumn<T>::insert(const T& new_value) {
+        std::pair<unsigned int, unsigned int> code = encode(new_value);
+        if(size() % RANK_BLOCK_SIZE == 0) {
+            for(unsigned int tier = 0; tier < FREQUENCY_TIERS; tier++) {
+                rankDirectory.push_back(tierCodes[tier].size());
+            }
+        }
+        tierIds.push_back(code.first);
+        tierCodes[code.first].push_back(code.second);
+
+        if(size() >= REPARTITION_MIN_ROWS && size() >= 2 * partitionedRows) {
+            repartition();
+        }
+
+        return true;
+    }
+
+    template <typename T>
+    template <typename InputIterator>
+    bool FrequencyPartitionedColumn<T>::insert(InputIterator first, InputIterator last){
+        for(; first != last; ++first) {
+            insert(*first);
+        }
+        return true;
+    }
+
+    template<class T>
+    const boost::any FrequencyPartitionedColumn<T>::get(TID){
+        // NOT NECESSARY FOR OUR PROGRAMMING TASK (NOT USED BY UNIT TEST).
+        return boost::any();
+    }
+
+    template<class T>
+    void FrequencyPartitionedColumn<T>::print() const throw(){
+        // NOT NECESSARY FOR OUR PROGRAMMING TASK (NOT USED BY UNIT TEST).
+    }
+
+    template<class T>
+    size_t FrequencyPartitionedColumn<T>::size() const throw(){
+        return tierIds.size();
+    }
+
+    template<class T>
+    const ColumnPtr FrequencyPartitionedColumn<T>::copy() const{
+        return ColumnPtr(new FrequencyPartitionedColumn<T>(*this));
+    }
+
+    template<class T>
+    bool FrequencyPartitionedColumn<T>::update(TID tid, const boost::any& new_value){
+        if(tid >= size() || new_value.type() != typeid(T)) {
+            return false;
+        }
+
+        std::pair<unsigned int, unsigned int> code = encode(boost::any_cast<T>(new_value));
+        unsigned int oldTier = tierIds.get(tid);
+        TID oldRank = rank(tid, oldTier);
+        if(oldTier == code.first) {
+            tierCodes[oldTier].set(oldRank, code.second);
+            return true;
+        }
+
+        // the row moves to the code vector of another tier
+        tierCodes[oldTier].erase(oldRank);
+        tierCodes[code.first].insert(rank(tid, code.first), code.second);
+        tierIds.set(tid, code.first);
+        for(TID entry = (tid / RANK_BLOCK_SIZE + 1) * FREQUENCY_TIERS; entry < rankDirectory.size(); entry += FREQUENCY_TIERS) {
+            rankDirectory[entry + oldTier]--;
+            rankDirectory[entry + code.first]++;
+        }
+        cursorRanks.clear();
+
+        return true;
+    }
+
+    template<class T>
+    bool FrequencyPartitionedColumn<T>::update(PositionListPtr tids, const boost::any& new_value){
+        if(!tids || new_value.type() != typeid(T)) {
+            return false;
+        }
+
+        PositionList sortedTids(*tids);
+        std::sort(sortedTids.begin(), sortedTids.end());
+        if(!sortedTids.empty() && sortedTids.back() >= size()) {
+            return false;
+        }
+
+        // Encode all rows again in a single pass, the updated rows get the code of the new value.
+        std::pair<unsigned int, unsigned int> newCode = encode(boost::any_cast<T>(new_value));
+        BitPackedVector newTierIds(tierIds.getBitsPerValue());
+        std::vector<BitPackedVector> newTierCodes;
+        for(unsigned int tier = 0; tier < FREQUENCY_TIERS; tier++) {
+            newTierCodes.push_back(BitPackedVector(tierCodes[tier].getBitsPerValue()));
+        }
+        std::vector<TID> counters(FREQUENCY_TIERS, 0);
+        unsigned int k = 0;
+        for(TID i = 0; i < size(); i++) {
+            unsigned int tier = tierIds.get(i);
+            unsigned int code = tierCodes[tier].get(counters[tier]++);
+            if(k < sortedTids.size() && sortedTids[k] == i) {
+                tier = newCode.first;
+                code = newCode.second;
+                // skip duplicates
+                while(k < sortedTids.size() && sortedTids[k] == i) {
+                    k++;
+                }
+            }
+            newTierIds.push_back(tier);
+            newTierCodes[tier].push_back(code);
+        }
+
+        std::swap(tierIds, newTierIds);
+        tierCodes.swap(newTierCodes);
+        rebuildRankDirectory();
+        return true;
+    }
+
+    template<class T>
+    bool FrequencyPartitionedColumn<T>::remove(TID tid){
+        if(tid >= size()) {
+            return false;
+        }
+
+        unsigned int tier = tierIds.get(tid);
+        tierCodes[tier].erase(rank(tid, tier));
+        tierIds.erase(tid);
+        rebuildRankDirectory();
+
+        return true;
+    }
+
+    template<class T>
+    bool FrequencyPartitionedColumn<T>::remove(PositionListPtr tids){
+        if(!tids || tids->empty()) {
+            return false;
+        }
+
+        // Copy all remaining rows in a single pass.
+        BitPackedVector newTierIds(tierIds.getBitsPerValue());
+        std::vector<BitPackedVector> newTierCodes;
+        for(unsigned int tier = 0; tier < FREQUENCY_TIERS; tier++) {
+            newTierCodes.push_back(BitPackedVector(tierCodes[tier].getBitsPerValue()));
+        }
+        std::vector<TID> counters(FREQUENCY_TIERS, 0);
+        unsigned int k = 0;
+        for(TID i = 0; i < size(); i++) {
+            unsigned int tier = tierIds.get(i);
+            unsigned int code = tierCodes[tier].get(counters[tier]++);
+            if(k < tids->size() && (*tids)[k] == i) {
+                // skip duplicates
+                while(k < tids->size() && (*tids)[k] == i) {
+                    k++;
+                }
+                continue;
+            }
+            newTierIds.push_back(tier);
+            newTierCodes[tier].push_back(code);
+        }
+
+        std::swap(tierIds, newTierIds);
+        tierCodes.swap(newTierCodes);
+        rebuildRankDirectory();
+        return true;
+    }
+
+    template<class T>
+    bool FrequencyPartitionedColumn<T>::clearContent(){
+        tierIds.clear();
+        for(unsigned int tier = 0; tier < FREQUENCY_TIERS; tier++) {
+            tierCodes[tier].clear();
+            tierDictionaries[tier].clear();
+        }
+        valueCodes.clear();
+        rankDirectory.clear();
+        cursorRanks.clear();
+        partitionedRows = 0;
+        return true;
+    }
+
+    template<class T>
+    bool FrequencyPartitionedColumn<T>::store(const std::string& path_){
+        std::string path(path_);
+        path += _name;
+
+        std::ofstream outfile (path.c_str(), std::fstream::out | std::fstream::binary);
+        boost::archive::binary_oarchive oa(outfile);
+
+        oa << tierIds << tierCodes << tierDictionaries << partitionedRows;
+        outfile.flush();
+        outfile.close();
+
+        return true;
+    }
+
+    template<class T>
+    bool FrequencyPartitionedColumn<T>::load(const std::string& path_){
+        std::string path(path_);
+        path += _name;
+
+        std::ifstream infile (path.c_str(), std::fstream::in | std::fstream::binary);
+        boost::archive::binary_iarchive ia(infile);
+
+        ia >> tierIds >> tierCodes >> tierDictionaries >> partitionedRows;
+        infile.close();
+
+        rebuildValueCodes();
+        rebuildRankDirectory();
+        return true;
+    }
+
+    template<class T>
+    bool FrequencyPartitionedColumn<T>::supportsConcurrentReads() const throw(){
+        // operator[] moves the rank cursor
+        return false;
+    }
+
+    template<class T>
+    bool FrequencyPartitionedColumn<T>::applyOperation(ColumnAlgebraOperation op, const T& operand){
+        std::vector<std::vector<T> > dictionaries(tierDictionaries);
+        boost::unordered_map<T, std::pair<unsigned int, unsigned int> > codes;
+        for(unsigned int tier = 0; tier < FREQUENCY_TIERS; tier++) {
+            if(dictionaries[tier].empty()) {
+                continue;
+            }
+            apply_operation(&dictionaries[tier][0], dictionaries[tier].size(), op, operand);
+            for(unsigned int code = 0; code < dictionaries[tier].size(); code++) {
+                if(!codes.insert(std::make_pair(dictionaries[tier][code], std::make_pair(tier, code))).second) {
+                    // merging codes across tiers is not worth it, the column is encoded again
+                    return ColumnBaseTyped<T>::applyOperation(op, operand);
+                }
+            }
+        }
+        tierDictionaries.swap(dictionaries);
+        valueCodes.swap(codes);
+        return true;
+    }
+
+    template<class T>
+    T& FrequencyPartitionedColumn<T>::operator[](const int index){
+        TID tid = index;
+        if(cursorRanks.empty() || tid < cursorTid || tid - cursorTid >= RANK_BLOCK_SIZE) {
+            // start at the closest entry of the rank directory
+            TID block = tid / RANK_BLOCK_SIZE;
+            cursorTid = block * RANK_BLOCK_SIZE;
+            cursorRanks.assign(rankDirectory.begin() + block * FREQUENCY_TIERS, rankDirectory.begin() + (block + 1) * FREQUENCY_TIERS);
+        }
+        for(; cursorTid < tid; cursorTid++) {
+            cursorRanks[tierIds.get(cursorTid)]++;
+        }
+        unsigned int tier = tierIds.get(tid);
+        return tierDictionaries[tier][tierCodes[tier].get(cursorRanks[tier])];
+    }
+
+    template<class T>
+    void FrequencyPartitionedColumn<T>::decode(TID begin, TID end, T* out){
+        if(begin >= end) {
+            return;
+        }
+        TID block = begin / RANK_BLOCK_SIZE;
+        std::vector<TID> ranks(rankDirectory.begin() + block * FREQUENCY_TIERS, rankDirectory.begin() + (block + 1) * FREQUENCY_TIERS);
+        for(TID tid = block * RANK_BLOCK_SIZE; tid < begin; tid++) {
+            ranks[tierIds.get(tid)]++;
+        }
+        for(TID tid = begin; tid < end; tid++) {
+            unsigned int tier = tierIds.get(tid);
+            *out++ = tierDictionaries[tier][tierCodes[tier].get(ranks[tier]++)];
+        }
+    }
+
+    template<class T>
+    unsigned int FrequencyPartitionedColumn<T>::getSizeinBytes() const throw(){
+        unsigned int size = tierIds.getSizeinBytes();
+        for(unsigned int tier = 0; tier < FREQUENCY_TIERS; tier++) {
+            size += tierCodes[tier].getSizeinBytes();
+            size += tierDictionaries[tier].capacity() * sizeof(T);
+        }
+        size += valueCodes.size() * (sizeof(T) + 2 * sizeof(unsigned int));
+        size += rankDirectory.capacity() * sizeof(TID);
+        return size;
+    }
+
+/***************** End of Implementation Section ******************/
+
+
+
+}; //end namespace CogaDB
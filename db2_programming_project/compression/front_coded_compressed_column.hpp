@@ -0,0 +1,574 @@
+#pragma once
+
+#include <core/compressed_column.hpp>
+#include <core/bit_packed_vector.hpp>
+#include <core/simd_kernels.hpp>
+#include <algorithm>
+#include <boost/unordered_map.hpp>
+#include <boost/static_assert.hpp>
+#include <boost/type_traits/is_same.hpp>
+
+namespace CoGaDB{
+
+/*! \brief number of strings per bucket of a front coded dictionary, only the first string of a bucket is stored completely*/
+const unsigned int FRONT_CODING_BUCKET_SIZE = 16;
+
+/*!
+ *  \brief     This class represents a dictionary compressed string column with a front coded dictionary, is the base class for all compressed typed column classes.
+ *  \details   The distinct strings are sorted and stored in buckets of FRONT_CODING_BUCKET_SIZE strings in one byte array.
+ *             The first string of a bucket is stored completely, every following string as the length of the prefix it shares
+ *             with its predecessor and the remaining suffix. Every row stores the bit packed code of its string, which is the
+ *             rank of the string in the sorted dictionary.
+ *             New strings are appended to a small pending area, which is merged into the sorted dictionary once it grows beyond a
+ *             fraction of the dictionary. As the codes of the sorted part compare like the strings, equality, range and prefix
+ *             predicates become code ranges, which are evaluated on the packed codes with the SIMD kernels.
+ */
+template<class T>
+class FrontCodedCompressedColumn : public CompressedColumn<T>{
+    BOOST_STATIC_ASSERT((boost::is_same<T, std::string>::value));
+public:
+    /***************** constructors and destructor *****************/
+    FrontCodedCompressedColumn(const std::string& name, AttributeType db_type);
+    virtual ~FrontCodedCompressedColumn();
+
+    virtual bool insert(const boost::any& new_Value);
+    virtual bool insert(const T& new_value);
+    template <typename InputIterator>
+    bool insert(InputIterator first, InputIterator last);
+
+    virtual bool update(TID tid, const boost::any& new_value);
+    virtual bool update(PositionListPtr tid, const boost::any& new_value);
+
+    virtual bool remove(TID tid);
+    //assumes tid list is sorted ascending
+    virtual bool remove(PositionListPtr tid);
+    virtual bool clearContent();
+
+    virtual const boost::any get(TID tid);
+    //virtual const boost::any* const getRawData()=0;
+    virtual void print() const throw();
+    virtual size_t size() const throw();
+    virtual unsigned int getSizeinBytes() const throw();
+
+    virtual const ColumnPtr copy() const;
+
+    virtual bool store(const std::string& path);
+    virtual bool load(const std::string& path);
+
+    virtual const PositionListPtr selection(const boost::any& value_for_comparison, const ValueComparator comp);
+    /*! \brief returns the TIDs of all rows whose string starts with prefix*/
+    const PositionListPtr prefix_selection(const std::string& prefix);
+
+    virtual T& operator[](const int index);
+    virtual bool supportsConcurrentReads() const throw();
+
+    /*! merges the pending strings into the sorted dictionary, renumbers all codes and drops strings no row refers to*/
+    void rebuildDictionary();
+
+    /*! code of each row, codes below numberOfSortedValues refer to the sorted dictionary, the others to the pending strings*/
+    BitPackedVector columnEntries;
+    /*! front coded buckets of the sorted dictionary*/
+    std::vector<char> dictionaryBytes;
+    /*! offset of each bucket in dictionaryBytes*/
+    std::vector<unsigned int> bucketOffsets;
+    /*! number of strings in the sorted dictionary*/
+    unsigned int numberOfSortedValues;
+    /*! strings that were inserted since the last rebuild of the dictionary, the code of a string is numberOfSortedValues plus its index*/
+    std::vector<std::string> pendingValues;
+    std::string _name;
+
+private:
+    /*! returns the code of value, unknown values are added to the pending strings*/
+    unsigned int encode(const T& value);
+    /*! rebuilds the dictionary in case the pending area has grown too large*/
+    void rebuildIfNecessary();
+    /*! returns the first string of a bucket*/
+    std::string getBucketHeader(unsigned int bucket) const;
+    /*! decodes all strings of a bucket into decodedBucket, unless it is already cached*/
+    void decodeBucket(unsigned int bucket);
+    /*! returns the string of a code of the sorted dictionary*/
+    std::string& getSortedValue(unsigned int code);
+    /*! returns the code of the first string in the sorted dictionary that is not less than value*/
+    unsigned int lowerBound(const std::string& value);
+    /*! appends the TIDs of all rows with a code in [lowerCode, upperCode) or a pending code marked in pendingMatches to result*/
+    void findCodes(unsigned int lowerCode, unsigned int upperCode, const std::vector<bool>& pendingMatches, PositionList& result) const;
+
+    static void writeLength(std::vector<char>& bytes, unsigned int length);
+    static unsigned int readLength(const std::vector<char>& bytes, unsigned int& offset);
+    /*! stores the sorted strings values front coded in bytes and offsets*/
+    static void frontCode(const std::vector<std::string>& values, std::vector<char>& bytes, std::vector<unsigned int>& offsets);
+
+    /*! number of codes that are unpacked at once during a scan*/
+    static const unsigned int SCAN_BLOCK_SIZE = 1024;
+    /*! the pending area may hold at least this number of strings before the dictionary is rebuilt*/
+    static const unsigned int MIN_PENDING_VALUES = 64;
+
+    /*! maps each pending string to its code*/
+    boost::unordered_map<std::string, unsigned int> pendingCodes;
+    /*! strings of the bucket with index decodedBucketIndex*/
+    std::vector<std::string> decodedBucket;
+    /*! index of the cached bucket, the number of buckets marks an empty cache*/
+    unsigned int decodedBucketIndex;
+
+};
+
+
+/***************** Start of Implementation Section ******************/
+
+
+    template<class T>
+    FrontCodedCompressedColumn<T>::FrontCodedCompressedColumn(const std::string& name, AttributeType db_type)
+        : CompressedColumn<T>(name, db_type), columnEntries(), dictionaryBytes(), bucketOffsets(), numberOfSortedValues(0), pendingValues(),
+          _name(name), pendingCodes(), decodedBucket(), decodedBucketIndex(0) {
+
+    }
+
+    template<class T>
+    FrontCodedCompressedColumn<T>::~FrontCodedCompressedColumn(){
+
+    }
+
+    template<class T>
+    void FrontCodedCompressedColumn<T>::writeLength(std::vector<char>& bytes, unsigned int length) {
+        // 7 bits per byte, the highest bit marks that another byte follows
+        while(length >= 128) {
+            bytes.push_back(char((length & 127) | 128));
+            length >>= 7;
+        }
+        bytes.push_back(char(length));
+    }
+
+    template<class T>
+    unsigned int FrontCodedCompressedColumn<T>::readLength(const std::vector<char>& bytes, unsigned int& offset) {
+        unsigned int length = 0;
+        unsigned int shift = 0;
+        unsigned char byte;
+        do {
+            byte = bytes[offset++];
+            length |= (byte & 127u) << shift;
+            shift += 7;
+        } while(byte & 128);
+        return length;
+    }
+
+    template<class T>
+    void FrontCodedCompressedColumn<T>::frontCode(const std::vector<std::string>& values, std::vector<char>& bytes, std::vector<unsigned int>& offsets) {
+        bytes.clear();
+        offsets.clear();
+        for(unsigned int i = 0; i < values.size(); i++) {
+            if(i % FRONT_CODING_BUCKET_SIZE == 0) {
+                offsets.push_back(bytes.size());
+                writeLength(bytes, values[i].size());
+                bytes.insert(bytes.end(), values[i].begin(), values[i].end());
+                continue;
+            }
+            const std::string& previous = values[i - 1];
+            unsigned int shared = 0;
+            while(shared < previous.size() && shared < values[i].size() && previous[shared] == values[i][shared]) {
+                shared++;
+            }
+            writeLength(bytes, shared);
+            writeLength(bytes, values[i].size() - shared);
+            bytes.insert(bytes.end(), values[i].begin() + shared, values[i].end());
+        }
+    }
+
+    template<class T>
+    std::string FrontCodedCompressedColumn<T>::getBucketHeader(unsigned int bucket) const {
+        unsigned int offset = bucketOffsets[bucket];
+        unsigned int length = readLength(dictionaryBytes, offset);
+        return std::string(dictionaryBytes.begin() + offset, dictionaryBytes.begin() + offset + length);
+    }
+
+    template<class T>
+    void FrontCodedCompressedColumn<T>::decodeBucket(unsigned int bucket) {
+        if(decodedBucketIndex == bucket && bucket < bucketOffsets.size()) {
+            return;
+        }
+        unsigned int count = std::min(FRONT_CODING_BUCKET_SIZE, numberOfSortedValues - bucket * FRONT_CODING_BUCKET_SIZE);
+        decodedBucket.resize(count);
+        decodedBucket[0] = getBucketHeader(bucket);
+        unsigned int offset = bucketOffsets[bucket];
+        offset += readLength(dictionaryBytes, offset);
+        for(unsigned int i = 1; i < count; i++) {
+            unsigned int shared = readLength(dictionaryBytes, offset);
+            unsigned int suffix = readLength(dictionaryBytes, offset);
+            decodedBucket[i].assign(decodedBucket[i - 1], 0, shared);
+            decodedBucket[i].append(dictionaryBytes.begin() + offset, dictionaryBytes.begin() + offset + suffix);
+            offset += suffix;
+        }
+        decodedBucketIndex = bucket;
+    }
+
+    template<class T>
+    std::string& FrontCodedCompressedColumn<T>::getSortedValue(unsigned int code) {
+        decodeBucket(code / FRONT_CODING_BUCKET_SIZE);
+        return decodedBucket[code % FRONT_CODING_BUCKET_SIZE];
+    }
+
+    template<class T>
+    unsigned int FrontCodedCompressedColumn<T>::lowerBound(const std::string& value) {
+        // find the last bucket whose first string is not greater than value
+        unsigned int lower = 0, upper = bucketOffsets.size();
+        while(lower < upper) {
+            unsigned int middle = (lower + upper) / 2;
+            if(value < getBucketHeader(middle)) {
+                upper = middle;
+            } else {
+                lower = middle + 1;
+            }
+        }
+        if(lower == 0) {
+            return 0;
+        }
+
+        unsigned int bucket = lower - 1;
+        decodeBucket(bucket);
+        return bucket * FRONT_CODING_BUCKET_SIZE + (std::lower_bound(decodedBucket.begin(), decodedBucket.end(), value) - decodedBucket.begin());
+    }
+
+    template<class T>
+    unsigned int FrontCodedCompressedColumn<T>::encode(const T& value) {
+        unsigned int code = lowerBound(value);
+        if(code < numberOfSortedValues && getSortedValue(code) == value) {
+            return code;
+        }
+
+        boost::unordered_map<std::string, unsigned int>::const_iterator it = pendingCodes.find(value);
+        if(it != pendingCodes.end()) {
+            return it->second;
+        }
+        code = numberOfSortedValues + pendingValues.size();
+        pendingValues.push_back(value);
+        pendingCodes.insert(std::make_pair(value, code));
+        return code;
+    }
+
+    template<class T>
+    void FrontCodedCompressedColumn<T>::rebuildIfNecessary() {
+        unsigned int limit = numberOfSortedValues / 4;
+        if(limit < MIN_PENDING_VALUES) {
+            limit = MIN_PENDING_VALUES;
+        }
+        if(pendingValues.size() > limit) {
+            rebuildDictionary();
+        }
+    }
+
+    template<class T>
+    void FrontCodedCompressedColumn<T>::rebuildDictionary() {
+        unsigned int numberOfCodes = numberOfSortedValues + pendingValues.size();
+        std::vector<bool> used(numberOfCodes, false);
+        for(size_t i = 0; i < columnEntries.size(); i++) {
+            used[columnEntries.get(i)] = true;
+        }
+
+        // The sorted part is already sorted, so only the pending strings have to be sorted before both are merged.
+        std::vector<std::pair<std::string, unsigned int> > pending;
+        for(unsigned int i = 0; i < pendingValues.size(); i++) {
+            if(used[numberOfSortedValues + i]) {
+                pending.push_back(std::make_pair(pendingValues[i], numberOfSortedValues + i));
+            }
+        }
+        std::sort(pending.begin(), pending.end());
+
+        std::vector<std::string> values;
+        std::vector<unsigned int> newCodes(numberOfCodes, 0);
+        unsigned int p = 0;
+        for(unsigned int bucket = 0; bucket < bucketOffsets.size(); bucket++) {
+            decodeBucket(bucket);
+            for(unsigned int i = 0; i < decodedBucket.size(); i++) {
+                for(; p < pending.size() && pending[p].first < decodedBucket[i]; p++) {
+                    newCodes[pending[p].second] = values.size();
+                    values.push_back(pending[p].first);
+                }
+                unsigned int code = bucket * FRONT_CODING_BUCKET_SIZE + i;
+                if(used[code]) {
+                    newCodes[code] = values.size();
+                    values.push_back(decodedBucket[i]);
+                }
+            }
+        }
+        for(; p < pending.size(); p++) {
+            newCodes[pending[p].second] = values.size();
+            values.push_back(pending[p].first);
+        }
+
+        BitPackedVector newEntries(values.size() > 1 ? BitPackedVector::bitsRequired(values.size() - 1) : 0);
+        for(size_t i = 0; i < columnEntries.size(); i++) {
+            newEntries.push_back(newCodes[columnEntries.get(i)]);
+        }
+        std::swap(columnEntries, newEntries);
+        frontCode(values, dictionaryBytes, bucketOffsets);
+        numberOfSortedValues = values.size();
+        pendingValues.clear();
+        pendingCodes.clear();
+        decodedBucketIndex = bucketOffsets.size();
+    }
+
+    template<class T>
+    bool FrontCodedCompressedColumn<T>::insert(const boost::any&){
+        // NOT NECESSARY FOR OUR PROGRAMMING TASK (NOT USED BY UNIT TEST).
+        return false;
+    }
+
+    template<class T>
+    bool FrontCodedCompressedColumn<T>::insert(const T& new_value) {
+        columnEntries.push_back(encode(new_value));
+        rebuildIfNecessary();
+        return true;
+    }
+
+    template <typename T>
+    template <typename InputIterator>
+    bool FrontCodedCompressedColumn<T>::insert(InputIterator first, InputIterator last){
+        for(; first != last; ++first) {
+            columnEntries.push_back(encode(*first));
+        }
+        rebuildIfNecessary();
+        return true;
+    }
+
+    template<class T>
+    const boost::any FrontCodedCompressedColumn<T>::get(TID){
+        // NOT NECESSARY FOR OUR PROGRAMMING TASK (NOT USED BY UNIT TEST).
+        return boost::any();
+    }
+
+    template<class T>
+    void FrontCodedCompressedColumn<T>::print() const throw(){
+        // NOT NECESSARY FOR OUR PROGRAMMING TASK (NOT USED BY UNIT TEST).
+    }
+
+    template<class T>
+    size_t FrontCodedCompressedColumn<T>::size() const throw(){
+        return columnEntries.size();
+    }
+
+    template<class T>
+    const ColumnPtr FrontCodedCompressedColumn<T>::copy() const{
+        return ColumnPtr(new FrontCodedCompressedColumn<T>(*this));
+    }
+
+    template<class T>
+    bool FrontCodedCompressedColumn<T>::update(TID tid, const boost::any& new_value){
+        if(tid >= size() || new_value.type() != typeid(T)) {
+            return false;
+        }
+
+        columnEntries.set(tid, encode(boost::any_cast<T>(new_value)));
+        rebuildIfNecessary();
+        return true;
+    }
+
+    template<class T>
+    bool FrontCodedCompressedColumn<T>::update(PositionListPtr tids, const boost::any& new_value){
+        if(!tids || new_value.type() != typeid(T)) {
+            return false;
+        }
+        for(unsigned int i = 0; i < tids->size(); i++) {
+            if((*tids)[i] >= size()) {
+                return false;
+            }
+        }
+
+        unsigned int code = encode(boost::any_cast<T>(new_value));
+        for(unsigned int i = 0; i < tids->size(); i++) {
+            columnEntries.set((*tids)[i], code);
+        }
+        rebuildIfNecessary();
+        return true;
+    }
+
+    template<class T>
+    bool FrontCodedCompressedColumn<T>::remove(TID tid){
+        if(tid >= size()) {
+            return false;
+        }
+
+        columnEntries.erase(tid);
+        return true;
+    }
+
+    template<class T>
+    bool FrontCodedCompressedColumn<T>::remove(PositionListPtr tids){
+        if(!tids || tids->empty()) {
+            return false;
+        }
+
+        // Copy all remaining codes in a single pass.
+        BitPackedVector newEntries(columnEntries.getBitsPerValue());
+        unsigned int k = 0;
+        for(TID i = 0; i < size(); i++) {
+            if(k < tids->size() && (*tids)[k] == i) {
+                // skip duplicates
+                while(k < tids->size() && (*tids)[k] == i) {
+                    k++;
+                }
+                continue;
+            }
+            newEntries.push_back(columnEntries.get(i));
+        }
+        std::swap(columnEntries, newEntries);
+        return true;
+    }
+
+    template<class T>
+    bool FrontCodedCompressedColumn<T>::clearContent(){
+        columnEntries.clear();
+        dictionaryBytes.clear();
+        bucketOffsets.clear();
+        numberOfSortedValues = 0;
+        pendingValues.clear();
+        pendingCodes.clear();
+        decodedBucketIndex = 0;
+        return true;
+    }
+
+    template<class T>
+    bool FrontCodedCompressedColumn<T>::store(const std::string& path_){
+        std::string path(path_);
+        path += _name;
+
+        std::ofstream outfile (path.c_str(), std::fstream::out | std::fstream::binary);
+        boost::archive::binary_oarchive oa(outfile);
+
+        oa << columnEntries << dictionaryBytes << bucketOffsets << numberOfSortedValues << pendingValues;
+        outfile.flush();
+        outfile.close();
+
+        return true;
+    }
+
+    template<class T>
+    bool FrontCodedCompressedColumn<T>::load(const std::string& path_){
+        std::string path(path_);
+        path += _name;
+
+        std::ifstream infile (path.c_str(), std::fstream::in | std::fstream::binary);
+        boost::archive::binary_iarchive ia(infile);
+
+        ia >> columnEntries >> dictionaryBytes >> bucketOffsets >> numberOfSortedValues >> pendingValues;
+        infile.close();
+
+        pendingCodes.clear();
+        for(unsigned int i = 0; i < pendingValues.size(); i++) {
+            pendingCodes.insert(std::make_pair(pendingValues[i], numberOfSortedValues + i));
+        }
+        decodedBucketIndex = bucketOffsets.size();
+        return true;
+    }
+
+    template<class T>
+    void FrontCodedCompressedColumn<T>::findCodes(unsigned int lowerCode, unsigned int upperCode, const std::vector<bool>& pendingMatches, PositionList& result) const {
+        bool pendingMatch = std::find(pendingMatches.begin(), pendingMatches.end(), true) != pendingMatches.end();
+        if(lowerCode >= upperCode && !pendingMatch) {
+            return;
+        }
+
+        boost::uint32_t codes[SCAN_BLOCK_SIZE];
+        for(size_t begin = 0; begin < columnEntries.size(); begin += SCAN_BLOCK_SIZE) {
+            size_t count = std::min(size_t(SCAN_BLOCK_SIZE), columnEntries.size() - begin);
+            columnEntries.unpack(begin, count, codes);
+            if(!pendingMatch) {
+                find_in_range(codes, count, lowerCode, upperCode, begin, result);
+                continue;
+            }
+            for(size_t i = 0; i < count; i++) {
+                if(codes[i] >= numberOfSortedValues ? pendingMatches[codes[i] - numberOfSortedValues] : (codes[i] >= lowerCode && codes[i] < upperCode)) {
+                    result.push_back(begin + i);
+                }
+            }
+        }
+    }
+
+    template<class T>
+    const PositionListPtr FrontCodedCompressedColumn<T>::selection(const boost::any& value_for_comparison, const ValueComparator comp){
+        if(value_for_comparison.type() != typeid(T)) {
+            std::cout << "Fatal Error!!! Typemismatch for column " << _name << std::endl;
+            std::cout << "File: " << __FILE__ << " Line: " << __LINE__ << std::endl;
+            exit(-1);
+        }
+
+        T value = boost::any_cast<T>(value_for_comparison);
+        // the strings of the sorted dictionary that fulfill the predicate have consecutive codes
+        unsigned int lowerCode = lowerBound(value);
+        unsigned int equalEnd = lowerCode;
+        if(lowerCode < numberOfSortedValues && getSortedValue(lowerCode) == value) {
+            equalEnd++;
+        }
+
+        std::vector<bool> pendingMatches(pendingValues.size(), false);
+        for(unsigned int i = 0; i < pendingValues.size(); i++) {
+            pendingMatches[i] = (comp == EQUAL && pendingValues[i] == value) || (comp == LESSER && pendingValues[i] < value) || (comp == GREATER && pendingValues[i] > value);
+        }
+
+        PositionListPtr result_tids(new PositionList());
+        if(comp == EQUAL) {
+            findCodes(lowerCode, equalEnd, pendingMatches, *result_tids);
+        } else if(comp == LESSER) {
+            findCodes(0, lowerCode, pendingMatches, *result_tids);
+        } else if(comp == GREATER) {
+            findCodes(equalEnd, numberOfSortedValues, pendingMatches, *result_tids);
+        }
+        return result_tids;
+    }
+
+    template<class T>
+    const PositionListPtr FrontCodedCompressedColumn<T>::prefix_selection(const std::string& prefix){
+        // All strings starting with prefix lie between prefix and its successor, which increments the last character that
+        // is not the largest character.
+        std::string successor(prefix);
+        while(!successor.empty() && static_cast<unsigned char>(successor[successor.size() - 1]) == 255) {
+            successor.erase(successor.size() - 1);
+        }
+        unsigned int lowerCode = lowerBound(prefix);
+        unsigned int upperCode = numberOfSortedValues;
+        if(!successor.empty()) {
+            successor[successor.size() - 1] = char(static_cast<unsigned char>(successor[successor.size() - 1]) + 1);
+            upperCode = lowerBound(successor);
+        }
+
+        std::vector<bool> pendingMatches(pendingValues.size(), false);
+        for(unsigned int i = 0; i < pendingValues.size(); i++) {
+            pendingMatches[i] = pendingValues[i].compare(0, prefix.size(), prefix) == 0;
+        }
+
+        PositionListPtr result_tids(new PositionList());
+        findCodes(lowerCode, upperCode, pendingMatches, *result_tids);
+        return result_tids;
+    }
+
+    template<class T>
+    bool FrontCodedCompressedColumn<T>::supportsConcurrentReads() const throw(){
+        // the decoded bucket is cached by operator[]
+        return false;
+    }
+
+    template<class T>
+    T& FrontCodedCompressedColumn<T>::operator[](const int index){
+        // The reference points into the bucket cache, it stays valid until another bucket is accessed.
+        unsigned int code = columnEntries.get(index);
+        if(code >= numberOfSortedValues) {
+            return pendingValues[code - numberOfSortedValues];
+        }
+        return getSortedValue(code);
+    }
+
+    template<class T>
+    unsigned int FrontCodedCompressedColumn<T>::getSizeinBytes() const throw(){
+        unsigned int size = columnEntries.getSizeinBytes();
+        size += dictionaryBytes.capacity();
+        size += bucketOffsets.capacity() * sizeof(unsigned int);
+        for(unsigned int i = 0; i < pendingValues.size(); i++) {
+            size += sizeof(std::string) + pendingValues[i].capacity();
+        }
+        size += pendingCodes.size() * (sizeof(std::string) + sizeof(unsigned int));
+        return size;
+    }
+
+/***************** End of Implementation Section ******************/
+
+
+
+}; //end namespace CogaDB
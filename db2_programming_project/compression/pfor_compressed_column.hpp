@@ -0,0 +1,683 @@
+#pragma once
+
+#include <core/compressed_column.hpp>
+#include <core/bit_packed_vector.hpp>
+#include <core/simd_kernels.hpp>
+#include <algorithm>
+#include <boost/cstdint.hpp>
+#include <boost/static_assert.hpp>
+#include <boost/type_traits/is_integral.hpp>
+
+namespace CoGaDB{
+
+/*! \brief maximum number of rows in a block of a PFOR compressed column*/
+const unsigned int PFOR_BLOCK_SIZE = 128;
+
+/*!
+ *  \brief     A PForBlock stores up to PFOR_BLOCK_SIZE values as offsets to a reference value (frame of reference), bit packed
+ *             with a common width. Values outside of [base, base+2^width) are stored as exceptions, their packed slot is zero.
+ */
+template<class T>
+struct PForBlock{
+    PForBlock() : base(), minValue(), maxValue(), offsets(), exceptionPositions(), exceptionValues() {}
+
+    /*! reference value of the block*/
+    T base;
+    /*! smallest and largest value of the block, including the exceptions*/
+    T minValue;
+    T maxValue;
+    /*! value minus base of every row, zero for exceptions*/
+    BitPackedVector offsets;
+    /*! positions of the exceptions within the block, sorted ascending*/
+    std::vector<boost::uint16_t> exceptionPositions;
+    /*! values of the exceptions*/
+    std::vector<T> exceptionValues;
+
+    template<class Archive>
+    void serialize(Archive& ar, const unsigned int){
+        ar & base & minValue & maxValue & offsets & exceptionPositions & exceptionValues;
+    }
+};
+
+/*!
+ *  \brief     This class represents a PFOR (patched frame of reference) compressed column with type T, is the base class for all compressed typed column classes.
+ *  \details   The rows are split into blocks of at most PFOR_BLOCK_SIZE rows. For every block, the bit width and reference value
+ *             are chosen to minimize its size, values that do not fit are patched in as exceptions. Selections skip or accept
+ *             whole blocks by their minimum and maximum and otherwise compare the packed offsets with the SIMD kernels.
+ *             SUM, MIN and MAX are computed from the block headers and packed offsets without decoding the rows.
+ */
+template<class T>
+class PForCompressedColumn : public CompressedColumn<T>{
+    // offsets are computed with integer arithmetic
+    BOOST_STATIC_ASSERT(boost::is_integral<T>::value);
+public:
+    /***************** constructors and destructor *****************/
+    PForCompressedColumn(const std::string& name, AttributeType db_type);
+    virtual ~PForCompressedColumn();
+
+    virtual bool insert(const boost::any& new_Value);
+    virtual bool insert(const T& new_value);
+    template <typename InputIterator>
+    bool insert(InputIterator first, InputIterator last);
+
+    virtual bool update(TID tid, const boost::any& new_value);
+    virtual bool update(PositionListPtr tid, const boost::any& new_value);
+
+    virtual bool remove(TID tid);
+    //assumes tid list is sorted ascending
+    virtual bool remove(PositionListPtr tid);
+    virtual bool clearContent();
+
+    virtual const boost::any get(TID tid);
+    //virtual const boost::any* const getRawData()=0;
+    virtual void print() const throw();
+    virtual size_t size() const throw();
+    virtual unsigned int getSizeinBytes() const throw();
+
+    virtual const ColumnPtr copy() const;
+
+    virtual bool store(const std::string& path);
+    virtual bool load(const std::string& path);
+
+    virtual const PositionListPtr selection(const boost::any& value_for_comparison, const ValueComparator comp);
+
+    /*! \brief returns the SUM, MIN or MAX of all rows as 64 bit integer (zero for an empty column), so the SUM does not overflow like T*/
+    boost::int64_t aggregate(AggregationMethod method) const;
+    /*! \brief returns the sum of all rows as 64 bit integer, so it does not overflow like T*/
+    boost::int64_t sum() const;
+
+    virtual T& operator[](const int index);
+    /*! decodes every block in the range once and copies its values, instead of checking the block cache per row*/
+    virtual void decode(TID begin, TID end, T* out);
+    virtual void gather(const TID* tids, size_t count, T* out);
+    virtual bool supportsConcurrentReads() const throw();
+
+    /*! end position (exclusive) of each block*/
+    std::vector<TID> blockEnds;
+    /*! encoded blocks*/
+    std::vector<PForBlock<T> > blocks;
+    std::string _name;
+
+protected:
+    /*! an addition or subtraction only changes the reference values, bounds and exceptions, as the offsets stay the same,
+     *  other operations encode every block again*/
+    virtual bool applyOperation(ColumnAlgebraOperation op, const T& operand);
+
+private:
+    /*! returns the index of the block containing tid, or the number of blocks in case tid is out of bounds*/
+    unsigned int findBlock(TID tid) const;
+    /*! returns the position of the first row of a block*/
+    TID getBlockStart(unsigned int block) const;
+    /*! decodes a block into decodedBlock, unless it is already cached*/
+    void decodeBlock(unsigned int block);
+    /*! encodes values into block, choosing the bit width and reference value with the smallest size*/
+    static void encodeValues(const std::vector<T>& values, PForBlock<T>& block);
+    /*! appends the TIDs of all rows of a block that fulfill the predicate to result*/
+    void selectInBlock(unsigned int block, const T& value, const ValueComparator comp, PositionList& result) const;
+    static bool matches(const T& rowValue, const T& value, const ValueComparator comp);
+    static boost::uint64_t offset(const T& base, const T& value);
+
+    /*! values of the block with index decodedBlockIndex*/
+    std::vector<T> decodedBlock;
+    /*! index of the cached block, the number of blocks marks an empty cache*/
+    unsigned int decodedBlockIndex;
+
+};
+
+
+/***************** Start of Implementation Section ******************/
+
+
+    template<class T>
+    PForCompressedColumn<T>::PForCompressedColumn(const std::string& name, AttributeType db_type) : CompressedColumn<T>(name, db_type), blockEnds(), blocks(), _name(name), decodedBlock(), decodedBlockIndex(0) {
+
+    }
+
+    template<class T>
+    PForCompressedColumn<T>::~PForCompressedColumn(){
+
+    }
+
+    template<class T>
+    boost::uint64_t PForCompressedColumn<T>::offset(const T& base, const T& value) {
+        // the difference wraps around in unsigned arithmetic, so it is correct for value >= base
+        return boost::uint64_t(value) - boost::uint64_t(base);
+    }
+
+    template<class T>
+    bool PForCompressedColumn<T>::matches(const T& rowValue, const T& value, const ValueComparator comp) {
+        if(comp == EQUAL) {
+            return rowValue == value;
+        } else if(comp == LESSER) {
+            return rowValue < value;
+        } else if(comp == GREATER) {
+            return rowValue > value;
+        }
+        return false;
+    }
+
+    template<class T>
+    unsigned int PForCompressedColumn<T>::findBlock(TID tid) const {
+        // the first block ending behind tid contains it
+        return std::upper_bound(blockEnds.begin(), blockEnds.end(), tid) - blockEnds.begin();
+    }
+
+    template<class T>
+    TID PForCompressedColumn<T>::getBlockStart(unsigned int block) const {
+        return (block == 0) ? 0 : blockEnds[block - 1];
+    }
+
+    template<class T>
+    void PForCompressedColumn<T>::decodeBlock(unsigned int block) {
+        if(decodedBlockIndex == block && block < blockEnds.size()) {
+            return;
+        }
+        const PForBlock<T>& b = blocks[block];
+        decodedBlock.resize(b.offsets.size());
+        for(size_t i = 0; i < b.offsets.size(); i++) {
+            decodedBlock[i] = T(boost::uint64_t(b.base) + b.offsets.get(i));
+        }
+        for(size_t i = 0; i < b.exceptionPositions.size(); i++) {
+            decodedBlock[b.exceptionPositions[i]] = b.exceptionValues[i];
+        }
+        decodedBlockIndex = block;
+    }
+
+    template<class T>
+    void PForCompressedColumn<T>::encodeValues(const std::vector<T>& values, PForBlock<T>& block) {
+        std::vector<T> sorted(values);
+        std::sort(sorted.begin(), sorted.end());
+        const unsigned int n = sorted.size();
+        const unsigned int typeBits = sizeof(T) * 8;
+        // an exception costs its value and its position
+        const boost::uint64_t exceptionBits = typeBits + 16;
+
+        // For every width, the window [base, base+2^width) covering most values is found with two pointers over the sorted values.
+        unsigned int bestWidth = typeBits;
+        T bestBase = sorted[0];
+        boost::uint64_t bestCost = boost::uint64_t(n) * typeBits;
+        for(unsigned int width = 0; width < typeBits; width++) {
+            boost::uint64_t windowSize = boost::uint64_t(1) << width;
+            unsigned int covered = 0, start = 0, first = 0;
+            for(unsigned int end = 0; end < n; end++) {
+                while(offset(sorted[first], sorted[end]) >= windowSize) {
+                    first++;
+                }
+                if(end - first + 1 > covered) {
+                    covered = end - first + 1;
+                    start = first;
+                }
+            }
+            boost::uint64_t cost = boost::uint64_t(n) * width + (n - covered) * exceptionBits;
+            if(cost < bestCost) {
+                bestCost = cost;
+                bestWidth = width;
+                bestBase = sorted[start];
+            }
+        }
+
+        block.base = bestBase;
+        block.minValue = sorted.front();
+        block.maxValue = sorted.back();
+        block.offsets = BitPackedVector(bestWidth);
+        block.exceptionPositions.clear();
+        block.exceptionValues.clear();
+        for(unsigned int i = 0; i < n; i++) {
+            if(values[i] < bestBase || (bestWidth < typeBits && offset(bestBase, values[i]) >> bestWidth)) {
+                block.offsets.push_back(0);
+                block.exceptionPositions.push_back(i);
+                block.exceptionValues.push_back(values[i]);
+            } else {
+                block.offsets.push_back(offset(bestBase, values[i]));
+            }
+        }
+    }
+
+    template<class T>
+    bool PForCompressedColumn<T>::insert(const boost::any&){
+        // NOT NECESSARY FOR OUR PROGRAMMING TASK (NOT USED BY UNIT TEST).
+        return false;
+    }
+
+    template<class T>
+    bool PForCompressedColumn<T>::insert(const T& new_value) {
+        if(blockEnds.empty() || blockEnds.back() - getBlockStart(blockEnds.size() - 1) == PFOR_BLOCK_SIZE) {
+            blockEnds.push_back(size());
+            blocks.push_back(PForBlock<T>());
+            decodedBlock.clear();
+            decodedBlockIndex = blockEnds.size() - 1;
+        }
+
+        // The cache holds the last block during a sequence of inserts. The block is encoded again whenever its size reaches
+        // a power of two, so every row is encoded a constant number of times on average.
+        unsigned int last = blockEnds.size() - 1;
+        decodeBlock(last);
+        decodedBlock.push_back(new_value);
+        blockEnds[last]++;
+        PForBlock<T>& block = blocks[last];
+        unsigned int rows = decodedBlock.size();
+        if((rows & (rows - 1)) == 0 || rows == PFOR_BLOCK_SIZE) {
+            encodeValues(decodedBlock, block);
+            return true;
+        }
+
+        block.minValue = std::min(block.minValue, new_value);
+        block.maxValue = std::max(block.maxValue, new_value);
+        unsigned int width = block.offsets.getBitsPerValue();
+        if(new_value < block.base || (width < sizeof(T) * 8 && offset(block.base, new_value) >> width)) {
+            block.offsets.push_back(0);
+            block.exceptionPositions.push_back(rows - 1);
+            block.exceptionValues.push_back(new_value);
+        } else {
+            block.offsets.push_back(offset(block.base, new_value));
+        }
+
+        return true;
+    }
+
+    template <typename T>
+    template <typename InputIterator>
+    bool PForCompressedColumn<T>::insert(InputIterator first, InputIterator last){
+        for(; first != last; ++first) {
+            insert(*first);
+        }
+        return true;
+    }
+
+    template<class T>
+    const boost::any PForCompressedColumn<T>::get(TID){
+        // NOT NECESSARY FOR OUR PROGRAMMING TASK (NOT USED BY UNIT TEST).
+        return boost::any();
+    }
+
+    template<class T>
+    void PForCompressedColumn<T>::print() const throw(){
+        // NOT NECESSARY FOR OUR PROGRAMMING TASK (NOT USED BY UNIT TEST).
+    }
+
+    template<class T>
+    size_t PForCompressedColumn<T>::size() const throw(){
+        if(blockEnds.empty()) {
+            return 0;
+        }
+        return blockEnds.back();
+    }
+
+    template<class T>
+    const ColumnPtr PForCompressedColumn<T>::copy() const{
+        return ColumnPtr(new PForCompressedColumn<T>(*this));
+    }
+
+    template<class T>
+    bool PForCompressedColumn<T>::update(TID tid, const boost::any& new_value){
+        if(tid >= size() || new_value.type() != typeid(T)) {
+            return false;
+        }
+
+        unsigned int block = findBlock(tid);
+        decodeBlock(block);
+        decodedBlock[tid - getBlockStart(block)] = boost::any_cast<T>(new_value);
+        encodeValues(decodedBlock, blocks[block]);
+
+        return true;
+    }
+
+    template<class T>
+    bool PForCompressedColumn<T>::update(PositionListPtr tids, const boost::any& new_value){
+        if(!tids || new_value.type() != typeid(T)) {
+            return false;
+        }
+
+        T value = boost::any_cast<T>(new_value);
+        PositionList sortedTids(*tids);
+        std::sort(sortedTids.begin(), sortedTids.end());
+        if(!sortedTids.empty() && sortedTids.back() >= size()) {
+            return false;
+        }
+
+        // every affected block is decoded and encoded once
+        unsigned int k = 0;
+        while(k < sortedTids.size()) {
+            unsigned int block = findBlock(sortedTids[k]);
+            decodeBlock(block);
+            TID start = getBlockStart(block);
+            for(; k < sortedTids.size() && sortedTids[k] < blockEnds[block]; k++) {
+                decodedBlock[sortedTids[k] - start] = value;
+            }
+            encodeValues(decodedBlock, blocks[block]);
+        }
+
+        return true;
+    }
+
+    template<class T>
+    bool PForCompressedColumn<T>::remove(TID tid){
+        if(tid >= size()) {
+            return false;
+        }
+
+        unsigned int block = findBlock(tid);
+        if(blockEnds[block] - getBlockStart(block) == 1) {
+            blockEnds.erase(blockEnds.begin() + block);
+            blocks.erase(blocks.begin() + block);
+            decodedBlockIndex = blockEnds.size();
+        } else {
+            decodeBlock(block);
+            decodedBlock.erase(decodedBlock.begin() + (tid - getBlockStart(block)));
+            encodeValues(decodedBlock, blocks[block]);
+            blockEnds[block]--;
+            block++;
+        }
+        for(unsigned int i = block; i < blockEnds.size(); i++) {
+            blockEnds[i]--;
+        }
+
+        return true;
+    }
+
+    template<class T>
+    bool PForCompressedColumn<T>::remove(PositionListPtr tids){
+        if(!tids || tids->empty()) {
+            return false;
+        }
+
+        // Single pass over the blocks: every affected block is encoded once, empty blocks are dropped.
+        std::vector<TID> newEnds;
+        std::vector<PForBlock<T> > newBlocks;
+        TID removedRows = 0;
+        unsigned int k = 0;
+        for(unsigned int block = 0; block < blockEnds.size(); block++) {
+            TID start = getBlockStart(block);
+            TID end = blockEnds[block];
+            if(k < tids->size() && (*tids)[k] < end) {
+                decodeBlock(block);
+                std::vector<T> remaining;
+                for(TID tid = start; tid < end; tid++) {
+                    if(k < tids->size() && (*tids)[k] == tid) {
+                        removedRows++;
+                        // skip duplicates
+                        while(k < tids->size() && (*tids)[k] == tid) {
+                            k++;
+                        }
+                    } else {
+                        remaining.push_back(decodedBlock[tid - start]);
+                    }
+                }
+                if(remaining.empty()) {
+                    continue;
+                }
+                newBlocks.push_back(PForBlock<T>());
+                encodeValues(remaining, newBlocks.back());
+            } else {
+                newBlocks.push_back(blocks[block]);
+            }
+            newEnds.push_back(end - removedRows);
+        }
+
+        blockEnds.swap(newEnds);
+        blocks.swap(newBlocks);
+        decodedBlockIndex = blockEnds.size();
+        return true;
+    }
+
+    template<class T>
+    bool PForCompressedColumn<T>::clearContent(){
+        blockEnds.clear();
+        blocks.clear();
+        decodedBlock.clear();
+        decodedBlockIndex = 0;
+        return true;
+    }
+
+    template<class T>
+    bool PForCompressedColumn<T>::store(const std::string& path_){
+        std::string path(path_);
+        path += _name;
+
+        std::ofstream outfile (path.c_str(), std::fstream::out | std::fstream::binary);
+        boost::archive::binary_oarchive oa(outfile);
+
+        oa << blockEnds << blocks;
+        outfile.flush();
+        outfile.close();
+
+        return true;
+    }
+
+    template<class T>
+    bool PForCompressedColumn<T>::load(const std::string& path_){
+        std::string path(path_);
+        path += _name;
+
+        std::ifstream infile (path.c_str(), std::fstream::in | std::fstream::binary);
+        boost::archive::binary_iarchive ia(infile);
+
+        ia >> blockEnds >> blocks;
+        infile.close();
+
+        decodedBlock.clear();
+        decodedBlockIndex = blockEnds.size();
+        return true;
+    }
+
+    template<class T>
+    void PForCompressedColumn<T>::selectInBlock(unsigned int blockIndex, const T& value, const ValueComparator comp, PositionList& result) const {
+        const PForBlock<T>& block = blocks[blockIndex];
+        TID start = getBlockStart(blockIndex);
+        TID end = blockEnds[blockIndex];
+
+        // the minimum and maximum decide most blocks without looking at the rows
+        bool allMatch = false, noneMatch = false;
+        if(comp == EQUAL) {
+            noneMatch = value < block.minValue || block.maxValue < value;
+            allMatch = block.minValue == value && block.maxValue == value;
+        } else if(comp == LESSER) {
+            noneMatch = !(block.minValue < value);
+            allMatch = block.maxValue < value;
+        } else if(comp == GREATER) {
+            noneMatch = !(block.maxValue > value);
+            allMatch = block.minValue > value;
+        }
+        if(noneMatch) {
+            return;
+        }
+        if(allMatch) {
+            for(TID tid = start; tid < end; tid++) {
+                result.push_back(tid);
+            }
+            return;
+        }
+
+        // Translate the predicate into a range of offsets [lower, upper) for the packed rows.
+        unsigned int width = block.offsets.getBitsPerValue();
+        boost::uint64_t slots = (width < 64) ? (boost::uint64_t(1) << width) : ~boost::uint64_t(0);
+        boost::uint64_t lower = 0, upper = 0;
+        if(comp == EQUAL) {
+            if(!(value < block.base) && offset(block.base, value) < slots) {
+                lower = offset(block.base, value);
+                upper = lower + 1;
+            }
+        } else if(comp == LESSER) {
+            if(block.base < value) {
+                upper = std::min(offset(block.base, value), slots);
+            }
+        } else if(comp == GREATER) {
+            if(value < block.base) {
+                upper = slots;
+            } else if(offset(block.base, value) + 1 < slots) {
+                lower = offset(block.base, value) + 1;
+                upper = slots;
+            }
+        }
+
+        PositionList candidates;
+        if(lower < upper) {
+            if(lower == 0 && upper == slots) {
+                for(TID tid = start; tid < end; tid++) {
+                    candidates.push_back(tid);
+                }
+            } else if(width <= 32) {
+                boost::uint32_t unpacked[PFOR_BLOCK_SIZE];
+                block.offsets.unpack(0, end - start, unpacked);
+                // upper wraps to 0 for 2^32, the kernels compare value-lower < upper-lower, which stays correct
+                find_in_range(unpacked, end - start, boost::uint32_t(lower), boost::uint32_t(upper), start, candidates);
+            } else {
+                for(TID tid = start; tid < end; tid++) {
+                    boost::uint64_t rowOffset = block.offsets.get(tid - start);
+                    if(rowOffset >= lower && rowOffset < upper) {
+                        candidates.push_back(tid);
+                    }
+                }
+            }
+        }
+
+        // Patch the exceptions: their packed slots are dropped from the candidates and their real values are checked.
+        unsigned int c = 0;
+        for(unsigned int e = 0; e < block.exceptionPositions.size(); e++) {
+            TID exceptionTid = start + block.exceptionPositions[e];
+            for(; c < candidates.size() && candidates[c] < exceptionTid; c++) {
+                result.push_back(candidates[c]);
+            }
+            if(c < candidates.size() && candidates[c] == exceptionTid) {
+                c++;
+            }
+            if(matches(block.exceptionValues[e], value, comp)) {
+                result.push_back(exceptionTid);
+            }
+        }
+        for(; c < candidates.size(); c++) {
+            result.push_back(candidates[c]);
+        }
+    }
+
+    template<class T>
+    const PositionListPtr PForCompressedColumn<T>::selection(const boost::any& value_for_comparison, const ValueComparator comp){
+        if(value_for_comparison.type() != typeid(T)) {
+            std::cout << "Fatal Error!!! Typemismatch for column " << _name << std::endl;
+            std::cout << "File: " << __FILE__ << " Line: " << __LINE__ << std::endl;
+            exit(-1);
+        }
+
+        T value = boost::any_cast<T>(value_for_comparison);
+        PositionListPtr result_tids(new PositionList());
+        for(unsigned int block = 0; block < blocks.size(); block++) {
+            selectInBlock(block, value, comp, *result_tids);
+        }
+        return result_tids;
+    }
+
+    template<class T>
+    boost::int64_t PForCompressedColumn<T>::aggregate(AggregationMethod method) const{
+        if(method == SUM || blocks.empty()) {
+            return sum();
+        }
+
+        // the bounds of the blocks are kept up to date, so no row has to be decoded
+        T result = (method == MIN) ? blocks[0].minValue : blocks[0].maxValue;
+        for(unsigned int block = 1; block < blocks.size(); block++) {
+            result = (method == MIN) ? std::min(result, blocks[block].minValue) : std::max(result, blocks[block].maxValue);
+        }
+        return boost::int64_t(result);
+    }
+
+    template<class T>
+    boost::int64_t PForCompressedColumn<T>::sum() const{
+        // every packed row contributes base plus its offset, the exceptions contribute their values,
+        // the unsigned sum wraps around and is exact as long as the signed result fits into 64 bits
+        boost::uint64_t sum = 0;
+        boost::uint32_t unpacked[PFOR_BLOCK_SIZE];
+        for(unsigned int b = 0; b < blocks.size(); b++) {
+            const PForBlock<T>& block = blocks[b];
+            size_t rows = block.offsets.size();
+            sum += boost::uint64_t(rows - block.exceptionValues.size()) * boost::uint64_t(block.base);
+            if(block.offsets.getBitsPerValue() <= 32) {
+                block.offsets.unpack(0, rows, unpacked);
+                for(size_t i = 0; i < rows; i++) {
+                    sum += unpacked[i];
+                }
+            } else {
+                for(size_t i = 0; i < rows; i++) {
+                    sum += block.offsets.get(i);
+                }
+            }
+            for(size_t i = 0; i < block.exceptionValues.size(); i++) {
+                sum += boost::uint64_t(block.exceptionValues[i]);
+            }
+        }
+        return boost::int64_t(sum);
+    }
+
+    template<class T>
+    bool PForCompressedColumn<T>::supportsConcurrentReads() const throw(){
+        // the decoded block is cached by operator[]
+        return false;
+    }
+
+    template<class T>
+    bool PForCompressedColumn<T>::applyOperation(ColumnAlgebraOperation op, const T& operand){
+        if(op == ADD || op == SUB) {
+            for(unsigned int block = 0; block < blocks.size(); block++) {
+                PForBlock<T>& b = blocks[block];
+                apply_operation(&b.base, 1, op, operand);
+                apply_operation(&b.minValue, 1, op, operand);
+                apply_operation(&b.maxValue, 1, op, operand);
+                if(!b.exceptionValues.empty()) {
+                    apply_operation(&b.exceptionValues[0], b.exceptionValues.size(), op, operand);
+                }
+            }
+            decodedBlockIndex = blockEnds.size();
+            return true;
+        }
+        for(unsigned int block = 0; block < blockEnds.size(); block++) {
+            decodeBlock(block);
+            apply_operation(&decodedBlock[0], decodedBlock.size(), op, operand);
+            encodeValues(decodedBlock, blocks[block]);
+        }
+        return true;
+    }
+
+    template<class T>
+    T& PForCompressedColumn<T>::operator[](const int index){
+        // The reference points into the block cache, it stays valid until another block is accessed.
+        TID tid = index;
+        if(decodedBlockIndex >= blockEnds.size() || tid < getBlockStart(decodedBlockIndex) || tid >= blockEnds[decodedBlockIndex]) {
+            decodeBlock(findBlock(tid));
+        }
+        return decodedBlock[tid - getBlockStart(decodedBlockIndex)];
+    }
+
+    template<class T>
+    void PForCompressedColumn<T>::decode(TID begin, TID end, T* out){
+        for(unsigned int block = findBlock(begin); begin < end; block++) {
+            decodeBlock(block);
+            TID blockStart = getBlockStart(block);
+            TID blockEnd = std::min(blockEnds[block], end);
+            out = std::copy(decodedBlock.begin() + (begin - blockStart), decodedBlock.begin() + (blockEnd - blockStart), out);
+            begin = blockEnd;
+        }
+    }
+
+    template<class T>
+    void PForCompressedColumn<T>::gather(const TID* tids, size_t count, T* out){
+        // consecutive TIDs of the same block are served from the block cache, without a virtual call per row
+        for(size_t i = 0; i < count; i++) {
+            out[i] = PForCompressedColumn<T>::operator[](tids[i]);
+        }
+    }
+
+    template<class T>
+    unsigned int PForCompressedColumn<T>::getSizeinBytes() const throw(){
+        unsigned int size = blockEnds.capacity() * sizeof(TID);
+        for(unsigned int i = 0; i < blocks.size(); i++) {
+            size += sizeof(PForBlock<T>) + blocks[i].offsets.getSizeinBytes();
+            size += blocks[i].exceptionPositions.capacity() * sizeof(boost::uint16_t);
+            size += blocks[i].exceptionValues.capacity() * sizeof(T);
+        }
+        return size;
+    }
+
+/***************** End of Implementation Section ******************/
+
+
+
+}; //end namespace CogaDB
@@ -2,12 +2,18 @@
 
 #include <core/compressed_column.hpp>
 #include <cstddef>
+#include <algorithm>
+#include <boost/serialization/utility.hpp>
 
 namespace CoGaDB{
 
 
 /*!
  *  \brief     This class represents a run length compressed column with type T, is the base class for all compressed typed column classes.
+ *  \details   Instead of the run lengths, the column stores the end position of every run (the prefix sum of the run lengths).
+ *             The run containing a TID is found by binary search, so random access costs O(log runs) and size() is O(1).
+ *             Updates and deletes split, shrink and merge runs in place, adjacent runs never have the same value.
+ *             Selections evaluate the predicate once per run and emit the TIDs of all matching runs, so they cost O(runs + result).
  */
 template<class T>
 class RunLengthCompressedColumn : public CompressedColumn<T>{
@@ -25,7 +31,7 @@ class RunLengthCompressedColumn : public CompressedColumn<T>{
     virtual bool update(PositionListPtr tid, const boost::any& new_value);
 
     virtual bool remove(TID tid);
-    //assumes tid list is sorted ascending
+    //the tid list may be unsorted and contain duplicates, a list with a tid beyond the last row is rejected
     virtual bool remove(PositionListPtr tid);
     virtual bool clearContent();
 
@@ -37,17 +43,44 @@ class RunLengthCompressedColumn : public CompressedColumn<T>{
 
     virtual const ColumnPtr copy() const;
 
+    virtual const PositionListPtr selection(const boost::any& value_for_comparison, const ValueComparator comp);
+    virtual const PositionListPtr parallel_selection(const boost::any& value_for_comparison, const ValueComparator comp, unsigned int number_of_threads);
+
     virtual bool store(const std::string& path);
     virtual bool load(const std::string& path);
 
 
 
     virtual T& operator[](const int index);
+    /*! finds the run of begin once and then copies the value of every run it passes*/
+    virtual void decode(TID begin, TID end, T* out);
+    /*! stays in the current run while the TIDs fall into it, e.g., for sorted TIDs, and searches the run otherwise*/
+    virtual void gather(const TID* tids, size_t count, T* out);
 
-    /*! values*/
-    std::pair<std::vector<unsigned int>, std::vector<T> > runLengthColumnPair;
+    /*! end position (exclusive) of each run (first) and the value of each run (second)*/
+    std::pair<std::vector<TID>, std::vector<T> > runLengthColumnPair;
     std::string _name;
 
+protected:
+    /*! computes the new value of every run once and merges neighbouring runs that became equal*/
+    virtual bool applyOperation(ColumnAlgebraOperation op, const T& operand);
+
+private:
+    /*! returns the index of the run containing tid, or the number of runs in case tid is out of bounds*/
+    unsigned int findRun(TID tid) const;
+    /*! returns the position of the first row of a run*/
+    TID getRunStart(unsigned int run) const;
+    /*! inserts a run with value and end position before run*/
+    void insertRun(unsigned int run, TID end, const T& value);
+    /*! merges run with its neighbours in case they have the same value*/
+    void mergeWithNeighbours(unsigned int run);
+    /*! appends count rows with value to the runs in ends and values, extending the last run if possible*/
+    static void appendRows(std::vector<TID>& ends, std::vector<T>& values, const T& value, TID count);
+    /*! returns the value of a selection after checking its type*/
+    const T getSelectionValue(const boost::any& value_for_comparison) const;
+    /*! appends the TIDs of all rows in [begin, end) that fulfill the predicate to result, the predicate is evaluated once per run*/
+    void selectRows(const T& value, const ValueComparator comp, TID begin, TID end, PositionList& result) const;
+
 };
 
 
@@ -70,10 +103,56 @@ class RunLengthCompressedColumn : public CompressedColumn<T>{
         return false;
     }
 
+    template<class T>
+    unsigned int RunLengthCompressedColumn<T>::findRun(TID tid) const {
+        // the first run ending behind tid contains it
+        return std::upper_bound(runLengthColumnPair.first.begin(), runLengthColumnPair.first.end(), tid) - runLengthColumnPair.first.begin();
+    }
+
+    template<class T>
+    TID RunLengthCompressedColumn<T>::getRunStart(unsigned int run) const {
+        return (run == 0) ? 0 : runLengthColumnPair.first[run - 1];
+    }
+
+    template<class T>
+    void RunLengthCompressedColumn<T>::insertRun(unsigned int run, TID end, const T& value) {
+        runLengthColumnPair.first.insert(runLengthColumnPair.first.begin() + run, end);
+        runLengthColumnPair.second.insert(runLengthColumnPair.second.begin() + run, value);
+    }
+
+    template<class T>
+    void RunLengthCompressedColumn<T>::mergeWithNeighbours(unsigned int run) {
+        std::vector<TID>& ends = runLengthColumnPair.first;
+        std::vector<T>& values = runLengthColumnPair.second;
+        if(run + 1 < values.size() && values[run] == values[run + 1]) {
+            ends[run] = ends[run + 1];
+            ends.erase(ends.begin() + run + 1);
+            values.erase(values.begin() + run + 1);
+        }
+        if(run > 0 && values[run - 1] == values[run]) {
+            ends[run - 1] = ends[run];
+            ends.erase(ends.begin() + run);
+            values.erase(values.begin() + run);
+        }
+    }
+
+    template<class T>
+    void RunLengthCompressedColumn<T>::appendRows(std::vector<TID>& ends, std::vector<T>& values, const T& value, TID count) {
+        if(count == 0) {
+            return;
+        }
+        if(!values.empty() && values.back() == value) {
+            ends.back() += count;
+        } else {
+            ends.push_back((ends.empty() ? 0 : ends.back()) + count);
+            values.push_back(value);
+        }
+    }
+
     template<class T>
     bool RunLengthCompressedColumn<T>::insert(const T& new_value) {
         if(runLengthColumnPair.first.size() == 0 || runLengthColumnPair.second.back() != new_value) {
-            runLengthColumnPair.first.push_back(1);
+            runLengthColumnPair.first.push_back(size() + 1);
             runLengthColumnPair.second.push_back(new_value);
         } else {
             runLengthColumnPair.first.back()++;
@@ -102,12 +181,10 @@ class RunLengthCompressedColumn : public CompressedColumn<T>{
 
     template<class T>
     size_t RunLengthCompressedColumn<T>::size() const throw(){
-        unsigned int counter = 0;
-        for(unsigned int i = 0; i < runLengthColumnPair.first.size(); i++) {
-            counter += runLengthColumnPair.first[i];
+        if(runLengthColumnPair.first.empty()) {
+            return 0;
         }
-
-        return counter;
+        return runLengthColumnPair.first.back();
     }
 
     template<class T>
@@ -117,62 +194,135 @@ class RunLengthCompressedColumn : public CompressedColumn<T>{
 
     template<class T>
     bool RunLengthCompressedColumn<T>::update(TID tid, const boost::any& new_value){
-        // Brute force approach. Recreates a simple vector representation of the column and turns back to "runLengthColumnPair" afterwards.
-        // This reduces the complexity of the code for the case, that the value - that has to be updated - has a frequency value higher than 1.
+        if(tid >= size() || new_value.type() != typeid(T)) {
+            return false;
+        }
+
+        T value = boost::any_cast<T>(new_value);
+        std::vector<TID>& ends = runLengthColumnPair.first;
+        unsigned int run = findRun(tid);
+        if(runLengthColumnPair.second[run] == value) {
+            return true;
+        }
 
-        std::vector<T> simpleColumnRepresentation;
-        for(unsigned int i = 0; i < runLengthColumnPair.first.size(); i++) {
-            for(unsigned int j = 0; j < runLengthColumnPair.first[i]; j++) {
-                simpleColumnRepresentation.push_back(runLengthColumnPair.second[i]);
+        TID start = getRunStart(run);
+        TID end = ends[run];
+        if(end - start == 1) {
+            // the run consists of this row only
+            runLengthColumnPair.second[run] = value;
+            mergeWithNeighbours(run);
+        } else if(tid == start) {
+            // cut the first row off the run
+            if(run > 0 && runLengthColumnPair.second[run - 1] == value) {
+                ends[run - 1]++;
+            } else {
+                insertRun(run, tid + 1, value);
             }
+        } else if(tid == end - 1) {
+            // cut the last row off the run, the next run grows automatically in case it has the same value
+            ends[run]--;
+            if(run + 1 == ends.size() || runLengthColumnPair.second[run + 1] != value) {
+                insertRun(run + 1, end, value);
+            }
+        } else {
+            // split the run into three runs
+            T oldValue = runLengthColumnPair.second[run];
+            ends[run] = tid;
+            insertRun(run + 1, tid + 1, value);
+            insertRun(run + 2, end, oldValue);
         }
 
-        if(tid >= simpleColumnRepresentation.size()) {
+        return true;
+    }
+
+    template<class T>
+    bool RunLengthCompressedColumn<T>::update(PositionListPtr tids, const boost::any& new_value){
+        if(!tids || new_value.type() != typeid(T)) {
             return false;
         }
 
-        simpleColumnRepresentation[tid] = boost::any_cast<T>(new_value);
+        T value = boost::any_cast<T>(new_value);
+        PositionList sortedTids(*tids);
+        std::sort(sortedTids.begin(), sortedTids.end());
+        sortedTids.erase(std::unique(sortedTids.begin(), sortedTids.end()), sortedTids.end());
+        if(!sortedTids.empty() && sortedTids.back() >= size()) {
+            return false;
+        }
 
-        // Restore the Run Length Compressed Column representation (runLengthColumnPair)
-        clearContent();
-        for(unsigned int i = 0; i < simpleColumnRepresentation.size(); i++) {
-            insert(simpleColumnRepresentation[i]);
+        // Rebuild the runs in a single pass: every updated row cuts its run and is appended as a run of its own (or merged).
+        std::vector<TID> newEnds;
+        std::vector<T> newValues;
+        unsigned int k = 0;
+        for(unsigned int run = 0; run < runLengthColumnPair.first.size(); run++) {
+            TID current = getRunStart(run);
+            TID end = runLengthColumnPair.first[run];
+            const T& runValue = runLengthColumnPair.second[run];
+            for(; k < sortedTids.size() && sortedTids[k] < end; k++) {
+                appendRows(newEnds, newValues, runValue, sortedTids[k] - current);
+                appendRows(newEnds, newValues, value, 1);
+                current = sortedTids[k] + 1;
+            }
+            appendRows(newEnds, newValues, runValue, end - current);
         }
 
+        runLengthColumnPair.first.swap(newEnds);
+        runLengthColumnPair.second.swap(newValues);
         return true;
     }
 
-    template<class T>
-    bool RunLengthCompressedColumn<T>::update(PositionListPtr, const boost::any&){
-        // NOT NECESSARY FOR OUR PROGRAMMING TASK (NOT USED BY UNIT TEST).
-        return false;
-    }
-
     template<class T>
     bool RunLengthCompressedColumn<T>::remove(TID tid){
-        unsigned int counter = 0;
-        for(unsigned int i = 0; i < runLengthColumnPair.first.size(); i++) {
-            for(unsigned int j = 0; j < runLengthColumnPair.first[i]; j++) {
-                if(counter == tid) {
-                    if(runLengthColumnPair.first[i] == 1) {
-                        runLengthColumnPair.first.erase(runLengthColumnPair.first.begin() + i);
-                        runLengthColumnPair.second.erase(runLengthColumnPair.second.begin() + i);
-                    } else {
-                        runLengthColumnPair.first[i]--;
-                    }
-                    return true;
-                }
-                counter++;
+        if(tid >= size()) {
+            return false;
+        }
+
+        unsigned int run = findRun(tid);
+        for(unsigned int i = run; i < runLengthColumnPair.first.size(); i++) {
+            runLengthColumnPair.first[i]--;
+        }
+
+        if(runLengthColumnPair.first[run] == getRunStart(run)) {
+            runLengthColumnPair.first.erase(runLengthColumnPair.first.begin() + run);
+            runLengthColumnPair.second.erase(runLengthColumnPair.second.begin() + run);
+            // the neighbours of the removed run may have the same value
+            if(run > 0 && run < runLengthColumnPair.second.size() && runLengthColumnPair.second[run - 1] == runLengthColumnPair.second[run]) {
+                runLengthColumnPair.first.erase(runLengthColumnPair.first.begin() + run - 1);
+                runLengthColumnPair.second.erase(runLengthColumnPair.second.begin() + run - 1);
             }
         }
 
-        return false;
+        return true;
     }
 
     template<class T>
-    bool RunLengthCompressedColumn<T>::remove(PositionListPtr){
-        // NOT NECESSARY FOR OUR PROGRAMMING TASK (NOT USED BY UNIT TEST).
-        return false;
+    bool RunLengthCompressedColumn<T>::remove(PositionListPtr tids){
+        if(!tids || tids->empty()) {
+            return false;
+        }
+
+        PositionList sortedTids(*tids);
+        std::sort(sortedTids.begin(), sortedTids.end());
+        sortedTids.erase(std::unique(sortedTids.begin(), sortedTids.end()), sortedTids.end());
+        if(sortedTids.back() >= size()) {
+            return false;
+        }
+
+        // Rebuild the runs in a single pass: every run shrinks by the number of removed rows it contains.
+        std::vector<TID> newEnds;
+        std::vector<T> newValues;
+        unsigned int k = 0;
+        for(unsigned int run = 0; run < runLengthColumnPair.first.size(); run++) {
+            TID end = runLengthColumnPair.first[run];
+            TID removedRows = 0;
+            for(; k < sortedTids.size() && sortedTids[k] < end; k++) {
+                removedRows++;
+            }
+            appendRows(newEnds, newValues, runLengthColumnPair.second[run], end - getRunStart(run) - removedRows);
+        }
+
+        runLengthColumnPair.first.swap(newEnds);
+        runLengthColumnPair.second.swap(newValues);
+        return true;
     }
 
     template<class T>
@@ -212,22 +362,114 @@ class RunLengthCompressedColumn : public CompressedColumn<T>{
     }
 
     template<class T>
-    T& RunLengthCompressedColumn<T>::operator[](const int index){
-        int counter = 0;
-        for(unsigned int i = 0; i < runLengthColumnPair.first.size(); i++) {
-            counter += runLengthColumnPair.first[i];
-            if(counter > index) {
-                return runLengthColumnPair.second[i];
+    const T RunLengthCompressedColumn<T>::getSelectionValue(const boost::any& value_for_comparison) const{
+        if(value_for_comparison.type() != typeid(T)) {
+            std::cout << "Fatal Error!!! Typemismatch for column " << this->name_ << std::endl;
+            std::cout << "File: " << __FILE__ << " Line: " << __LINE__ << std::endl;
+            exit(-1);
+        }
+        return boost::any_cast<T>(value_for_comparison);
+    }
+
+    template<class T>
+    void RunLengthCompressedColumn<T>::selectRows(const T& value, const ValueComparator comp, TID begin, TID end, PositionList& result) const{
+        const std::vector<TID>& ends = runLengthColumnPair.first;
+        const std::vector<T>& values = runLengthColumnPair.second;
+        for(unsigned int run = findRun(begin); run < ends.size() && getRunStart(run) < end; run++) {
+            bool matches = false;
+            if(comp == EQUAL) {
+                matches = values[run] == value;
+            } else if(comp == LESSER) {
+                matches = values[run] < value;
+            } else if(comp == GREATER) {
+                matches = values[run] > value;
+            }
+            if(matches) {
+                TID runEnd = std::min(ends[run], end);
+                for(TID tid = std::max(getRunStart(run), begin); tid < runEnd; tid++) {
+                    result.push_back(tid);
+                }
             }
         }
+    }
 
-        // Will result in an exception (out of bounds). This will point to a problem in this method (if there should be one).
-        return runLengthColumnPair.second[runLengthColumnPair.second.size()];
+    template<class T>
+    bool RunLengthCompressedColumn<T>::applyOperation(ColumnAlgebraOperation op, const T& operand){
+        std::vector<TID>& ends = runLengthColumnPair.first;
+        std::vector<T>& values = runLengthColumnPair.second;
+        if(values.empty()) {
+            return true;
+        }
+        apply_operation(&values[0], values.size(), op, operand);
+
+        unsigned int runs = 1;
+        for(unsigned int run = 1; run < values.size(); run++) {
+            if(values[run] == values[runs - 1]) {
+                ends[runs - 1] = ends[run];
+            } else {
+                ends[runs] = ends[run];
+                values[runs] = values[run];
+                runs++;
+            }
+        }
+        ends.resize(runs);
+        values.resize(runs);
+        return true;
+    }
+
+    template<class T>
+    const PositionListPtr RunLengthCompressedColumn<T>::selection(const boost::any& value_for_comparison, const ValueComparator comp){
+        T value = getSelectionValue(value_for_comparison);
+        PositionListPtr result_tids(new PositionList());
+        selectRows(value, comp, 0, size(), *result_tids);
+        return result_tids;
+    }
+
+    template<class T>
+    const PositionListPtr RunLengthCompressedColumn<T>::parallel_selection(const boost::any& value_for_comparison, const ValueComparator comp, unsigned int number_of_threads){
+        T value = getSelectionValue(value_for_comparison);
+        if(number_of_threads <= 1 || size() <= MORSEL_SIZE) {
+            return selection(value_for_comparison, comp);
+        }
+
+        // morsels are ranges of rows, so long matching runs are split between the threads as well
+        return parallel_scan(size(), number_of_threads,
+            boost::bind(&RunLengthCompressedColumn<T>::selectRows, this, value, comp, boost::placeholders::_1, boost::placeholders::_2, boost::placeholders::_3));
+    }
+
+    template<class T>
+    T& RunLengthCompressedColumn<T>::operator[](const int index){
+        // An index out of bounds results in runLengthColumnPair.second.size(), which points to a problem in the caller.
+        return runLengthColumnPair.second[findRun(index)];
+    }
+
+    template<class T>
+    void RunLengthCompressedColumn<T>::decode(TID begin, TID end, T* out){
+        const std::vector<TID>& ends = runLengthColumnPair.first;
+        const std::vector<T>& values = runLengthColumnPair.second;
+        for(unsigned int run = findRun(begin); begin < end; run++) {
+            TID runEnd = std::min(ends[run], end);
+            out = std::fill_n(out, runEnd - begin, values[run]);
+            begin = runEnd;
+        }
+    }
+
+    template<class T>
+    void RunLengthCompressedColumn<T>::gather(const TID* tids, size_t count, T* out){
+        const std::vector<TID>& ends = runLengthColumnPair.first;
+        const std::vector<T>& values = runLengthColumnPair.second;
+        unsigned int run = 0;
+        for(size_t i = 0; i < count; i++) {
+            if(run >= ends.size() || tids[i] < getRunStart(run) || tids[i] >= ends[run]) {
+                run = (run + 1 < ends.size() && tids[i] >= ends[run] && tids[i] < ends[run + 1]) ? run + 1 : findRun(tids[i]);
+            }
+            out[i] = values[run];
+        }
     }
 
     template<class T>
     unsigned int RunLengthCompressedColumn<T>::getSizeinBytes() const throw(){
-        int size = runLengthColumnPair.first.capacity() * sizeof(unsigned int);
+        unsigned int size = runLengthColumnPair.first.capacity() * sizeof(TID);
         size += runLengthColumnPair.second.capacity() * sizeof(T);
         return size;
     }
@@ -0,0 +1,507 @@
+#pragma once
+
+#include <core/compressed_column.hpp>
+#include <core/bitmap.hpp>
+#include <algorithm>
+#include <cstring>
+#include <boost/cstdint.hpp>
+#include <boost/static_assert.hpp>
+#include <boost/type_traits/is_floating_point.hpp>
+
+namespace CoGaDB{
+
+/*! \brief maximum number of rows in a block of a XOR compressed column*/
+const unsigned int XOR_BLOCK_SIZE = 128;
+
+/*!
+ *  \brief     This class represents a XOR compressed column with type T (Gorilla encoding), is the base class for all compressed typed column classes.
+ *  \details   Every value is XORed with its predecessor. An identical value costs one bit, otherwise only the meaningful bits
+ *             between the leading and trailing zeros of the XOR are stored, reusing the window of the previous value if
+ *             they fit into it. Slowly changing floating point values share sign, exponent and the high mantissa bits, so their
+ *             XOR has long runs of leading zeros.
+ *             The rows are split into blocks of at most XOR_BLOCK_SIZE rows, every block starts with an uncompressed value and
+ *             serves as access point. Random access decodes one block into a cache, so sequential scans decode every block once.
+ */
+template<class T>
+class XorCompressedColumn : public CompressedColumn<T>{
+    // the encoding works on the bit patterns of IEEE floating point values
+    BOOST_STATIC_ASSERT(boost::is_floating_point<T>::value && sizeof(T) <= 8);
+public:
+    /***************** constructors and destructor *****************/
+    XorCompressedColumn(const std::string& name, AttributeType db_type);
+    virtual ~XorCompressedColumn();
+
+    virtual bool insert(const boost::any& new_Value);
+    virtual bool insert(const T& new_value);
+    template <typename InputIterator>
+    bool insert(InputIterator first, InputIterator last);
+
+    virtual bool update(TID tid, const boost::any& new_value);
+    virtual bool update(PositionListPtr tid, const boost::any& new_value);
+
+    virtual bool remove(TID tid);
+    //assumes tid list is sorted ascending
+    virtual bool remove(PositionListPtr tid);
+    virtual bool clearContent();
+
+    virtual const boost::any get(TID tid);
+    //virtual const boost::any* const getRawData()=0;
+    virtual void print() const throw();
+    virtual size_t size() const throw();
+    virtual unsigned int getSizeinBytes() const throw();
+
+    virtual const ColumnPtr copy() const;
+
+    virtual bool store(const std::string& path);
+    virtual bool load(const std::string& path);
+
+
+
+    virtual T& operator[](const int index);
+    /*! decodes every block in the range once and copies its values, instead of checking the block cache per row*/
+    virtual void decode(TID begin, TID end, T* out);
+    virtual void gather(const TID* tids, size_t count, T* out);
+    virtual bool supportsConcurrentReads() const throw();
+
+    /*! end position (exclusive) of each block*/
+    std::vector<TID> blockEnds;
+    /*! encoded bits of each block*/
+    std::vector<Bitmap> blockStreams;
+    std::string _name;
+
+protected:
+    /*! the XORs of the new values have nothing in common with the old ones, so every block is decoded, changed and encoded again*/
+    virtual bool applyOperation(ColumnAlgebraOperation op, const T& operand);
+
+private:
+    /*! state of the encoder after a value: its bits and the window of meaningful bits of the last stored XOR*/
+    struct EncoderState{
+        EncoderState() : previous(0), leading(0), meaningful(0) {}
+        boost::uint64_t previous;
+        unsigned int leading;
+        /*! zero in case there is no window yet*/
+        unsigned int meaningful;
+    };
+
+    /*! returns the index of the block containing tid, or the number of blocks in case tid is out of bounds*/
+    unsigned int findBlock(TID tid) const;
+    /*! returns the position of the first row of a block*/
+    TID getBlockStart(unsigned int block) const;
+    /*! decodes a block into decodedBlock, unless it is already cached*/
+    void decodeBlock(unsigned int block);
+    /*! replaces the encoded data of a block with the values in decodedBlock*/
+    void encodeBlock(unsigned int block);
+    /*! encodes values into stream, returns the state after the last value*/
+    static EncoderState encodeValues(const std::vector<T>& values, Bitmap& stream);
+    /*! appends value to stream, the first value of a stream is stored uncompressed*/
+    static void appendValue(Bitmap& stream, EncoderState& state, const T& value);
+
+    static boost::uint64_t toBits(const T& value);
+    static T fromBits(boost::uint64_t bits);
+
+    /*! number of bits of a value*/
+    static const unsigned int VALUE_BITS = sizeof(T) * 8;
+
+    /*! values of the block with index decodedBlockIndex*/
+    std::vector<T> decodedBlock;
+    /*! index of the cached block, the number of blocks marks an empty cache*/
+    unsigned int decodedBlockIndex;
+    /*! encoder state after the last value of the cached block, used to append to the last block*/
+    EncoderState decodedState;
+
+};
+
+
+/***************** Start of Implementation Section ******************/
+
+
+    template<class T>
+    XorCompressedColumn<T>::XorCompressedColumn(const std::string& name, AttributeType db_type) : CompressedColumn<T>(name, db_type), blockEnds(), blockStreams(), _name(name), decodedBlock(), decodedBlockIndex(0), decodedState() {
+
+    }
+
+    template<class T>
+    XorCompressedColumn<T>::~XorCompressedColumn(){
+
+    }
+
+    template<class T>
+    boost::uint64_t XorCompressedColumn<T>::toBits(const T& value) {
+        boost::uint64_t bits = 0;
+        std::memcpy(&bits, &value, sizeof(T));
+        return bits;
+    }
+
+    template<class T>
+    T XorCompressedColumn<T>::fromBits(boost::uint64_t bits) {
+        T value;
+        std::memcpy(&value, &bits, sizeof(T));
+        return value;
+    }
+
+    template<class T>
+    void XorCompressedColumn<T>::appendValue(Bitmap& stream, EncoderState& state, const T& value) {
+        boost::uint64_t bits = toBits(value);
+        if(stream.size() == 0) {
+            stream.append(bits, VALUE_BITS);
+            state = EncoderState();
+            state.previous = bits;
+            return;
+        }
+
+        boost::uint64_t difference = bits ^ state.previous;
+        state.previous = bits;
+        if(difference == 0) {
+            // control bit 0: same value as before
+            stream.append(0, 1);
+            return;
+        }
+
+        // the leading zeros are stored with 5 bits
+        unsigned int leading = std::min(unsigned(__builtin_clzll(difference)) - (64 - VALUE_BITS), 31u);
+        unsigned int trailing = __builtin_ctzll(difference);
+        if(state.meaningful > 0 && leading >= state.leading && trailing >= VALUE_BITS - state.leading - state.meaningful) {
+            // control bits 10: the meaningful bits fit into the previous window
+            stream.append(1, 2);
+            stream.append(difference >> (VALUE_BITS - state.leading - state.meaningful), state.meaningful);
+        } else {
+            // control bits 11: a new window, 5 bits leading zeros, 6 bits number of meaningful bits minus one
+            unsigned int meaningful = VALUE_BITS - leading - trailing;
+            stream.append(3, 2);
+            stream.append(leading, 5);
+            stream.append(meaningful - 1, 6);
+            stream.append(difference >> trailing, meaningful);
+            state.leading = leading;
+            state.meaningful = meaningful;
+        }
+    }
+
+    template<class T>
+    typename XorCompressedColumn<T>::EncoderState XorCompressedColumn<T>::encodeValues(const std::vector<T>& values, Bitmap& stream) {
+        Bitmap encoded;
+        EncoderState state;
+        for(size_t i = 0; i < values.size(); i++) {
+            appendValue(encoded, state, values[i]);
+        }
+        std::swap(stream, encoded);
+        return state;
+    }
+
+    template<class T>
+    unsigned int XorCompressedColumn<T>::findBlock(TID tid) const {
+        // the first block ending behind tid contains it
+        return std::upper_bound(blockEnds.begin(), blockEnds.end(), tid) - blockEnds.begin();
+    }
+
+    template<class T>
+    TID XorCompressedColumn<T>::getBlockStart(unsigned int block) const {
+        return (block == 0) ? 0 : blockEnds[block - 1];
+    }
+
+    template<class T>
+    void XorCompressedColumn<T>::decodeBlock(unsigned int block) {
+        if(decodedBlockIndex == block && block < blockEnds.size()) {
+            return;
+        }
+        const Bitmap& stream = blockStreams[block];
+        TID rows = blockEnds[block] - getBlockStart(block);
+        decodedBlock.resize(rows);
+        EncoderState state;
+        state.previous = stream.read(0, VALUE_BITS);
+        decodedBlock[0] = fromBits(state.previous);
+        size_t pos = VALUE_BITS;
+        for(TID i = 1; i < rows; i++) {
+            if(stream.read(pos, 1) == 0) {
+                pos += 1;
+            } else {
+                if(stream.read(pos + 1, 1) == 1) {
+                    state.leading = stream.read(pos + 2, 5);
+                    state.meaningful = stream.read(pos + 7, 6) + 1;
+                    pos += 11;
+                }
+                pos += 2;
+                state.previous ^= stream.read(pos, state.meaningful) << (VALUE_BITS - state.leading - state.meaningful);
+                pos += state.meaningful;
+            }
+            decodedBlock[i] = fromBits(state.previous);
+        }
+        decodedBlockIndex = block;
+        decodedState = state;
+    }
+
+    template<class T>
+    void XorCompressedColumn<T>::encodeBlock(unsigned int block) {
+        decodedState = encodeValues(decodedBlock, blockStreams[block]);
+    }
+
+    template<class T>
+    bool XorCompressedColumn<T>::insert(const boost::any&){
+        // NOT NECESSARY FOR OUR PROGRAMMING TASK (NOT USED BY UNIT TEST).
+        return false;
+    }
+
+    template<class T>
+    bool XorCompressedColumn<T>::insert(const T& new_value) {
+        if(blockEnds.empty() || blockEnds.back() - getBlockStart(blockEnds.size() - 1) == XOR_BLOCK_SIZE) {
+            // start a new block, its first value is the access point
+            blockEnds.push_back(size());
+            blockStreams.push_back(Bitmap());
+            decodedBlock.clear();
+            decodedState = EncoderState();
+            decodedBlockIndex = blockEnds.size() - 1;
+        }
+
+        // the cache holds the last block during a sequence of inserts
+        unsigned int last = blockEnds.size() - 1;
+        decodeBlock(last);
+        appendValue(blockStreams[last], decodedState, new_value);
+        decodedBlock.push_back(new_value);
+        blockEnds[last]++;
+
+        return true;
+    }
+
+    template <typename T>
+    template <typename InputIterator>
+    bool XorCompressedColumn<T>::insert(InputIterator first, InputIterator last){
+        for(; first != last; ++first) {
+            insert(*first);
+        }
+        return true;
+    }
+
+    template<class T>
+    const boost::any XorCompressedColumn<T>::get(TID){
+        // NOT NECESSARY FOR OUR PROGRAMMING TASK (NOT USED BY UNIT TEST).
+        return boost::any();
+    }
+
+    template<class T>
+    void XorCompressedColumn<T>::print() const throw(){
+        // NOT NECESSARY FOR OUR PROGRAMMING TASK (NOT USED BY UNIT TEST).
+    }
+
+    template<class T>
+    size_t XorCompressedColumn<T>::size() const throw(){
+        if(blockEnds.empty()) {
+            return 0;
+        }
+        return blockEnds.back();
+    }
+
+    template<class T>
+    const ColumnPtr XorCompressedColumn<T>::copy() const{
+        return ColumnPtr(new XorCompressedColumn<T>(*this));
+    }
+
+    template<class T>
+    bool XorCompressedColumn<T>::update(TID tid, const boost::any& new_value){
+        if(tid >= size() || new_value.type() != typeid(T)) {
+            return false;
+        }
+
+        unsigned int block = findBlock(tid);
+        decodeBlock(block);
+        decodedBlock[tid - getBlockStart(block)] = boost::any_cast<T>(new_value);
+        encodeBlock(block);
+
+        return true;
+    }
+
+    template<class T>
+    bool XorCompressedColumn<T>::update(PositionListPtr tids, const boost::any& new_value){
+        if(!tids || new_value.type() != typeid(T)) {
+            return false;
+        }
+
+        T value = boost::any_cast<T>(new_value);
+        PositionList sortedTids(*tids);
+        std::sort(sortedTids.begin(), sortedTids.end());
+        if(!sortedTids.empty() && sortedTids.back() >= size()) {
+            return false;
+        }
+
+        // every affected block is decoded and encoded once
+        unsigned int k = 0;
+        while(k < sortedTids.size()) {
+            unsigned int block = findBlock(sortedTids[k]);
+            decodeBlock(block);
+            TID start = getBlockStart(block);
+            for(; k < sortedTids.size() && sortedTids[k] < blockEnds[block]; k++) {
+                decodedBlock[sortedTids[k] - start] = value;
+            }
+            encodeBlock(block);
+        }
+
+        return true;
+    }
+
+    template<class T>
+    bool XorCompressedColumn<T>::remove(TID tid){
+        if(tid >= size()) {
+            return false;
+        }
+
+        unsigned int block = findBlock(tid);
+        if(blockEnds[block] - getBlockStart(block) == 1) {
+            blockEnds.erase(blockEnds.begin() + block);
+            blockStreams.erase(blockStreams.begin() + block);
+            decodedBlockIndex = blockEnds.size();
+        } else {
+            decodeBlock(block);
+            decodedBlock.erase(decodedBlock.begin() + (tid - getBlockStart(block)));
+            encodeBlock(block);
+            blockEnds[block]--;
+            block++;
+        }
+        for(unsigned int i = block; i < blockEnds.size(); i++) {
+            blockEnds[i]--;
+        }
+
+        return true;
+    }
+
+    template<class T>
+    bool XorCompressedColumn<T>::remove(PositionListPtr tids){
+        if(!tids || tids->empty()) {
+            return false;
+        }
+
+        // Single pass over the blocks: every affected block is encoded once, empty blocks are dropped.
+        std::vector<TID> newEnds;
+        std::vector<Bitmap> newStreams;
+        TID removedRows = 0;
+        unsigned int k = 0;
+        for(unsigned int block = 0; block < blockEnds.size(); block++) {
+            TID start = getBlockStart(block);
+            TID end = blockEnds[block];
+            if(k < tids->size() && (*tids)[k] < end) {
+                decodeBlock(block);
+                std::vector<T> remaining;
+                for(TID tid = start; tid < end; tid++) {
+                    if(k < tids->size() && (*tids)[k] == tid) {
+                        removedRows++;
+                        // skip duplicates
+                        while(k < tids->size() && (*tids)[k] == tid) {
+                            k++;
+                        }
+                    } else {
+                        remaining.push_back(decodedBlock[tid - start]);
+                    }
+                }
+                if(remaining.empty()) {
+                    continue;
+                }
+                newStreams.push_back(Bitmap());
+                encodeValues(remaining, newStreams.back());
+            } else {
+                newStreams.push_back(blockStreams[block]);
+            }
+            newEnds.push_back(end - removedRows);
+        }
+
+        blockEnds.swap(newEnds);
+        blockStreams.swap(newStreams);
+        decodedBlockIndex = blockEnds.size();
+        return true;
+    }
+
+    template<class T>
+    bool XorCompressedColumn<T>::clearContent(){
+        blockEnds.clear();
+        blockStreams.clear();
+        decodedBlock.clear();
+        decodedBlockIndex = 0;
+        return true;
+    }
+
+    template<class T>
+    bool XorCompressedColumn<T>::store(const std::string& path_){
+        std::string path(path_);
+        path += _name;
+
+        std::ofstream outfile (path.c_str(), std::fstream::out | std::fstream::binary);
+        boost::archive::binary_oarchive oa(outfile);
+
+        oa << blockEnds << blockStreams;
+        outfile.flush();
+        outfile.close();
+
+        return true;
+    }
+
+    template<class T>
+    bool XorCompressedColumn<T>::load(const std::string& path_){
+        std::string path(path_);
+        path += _name;
+
+        std::ifstream infile (path.c_str(), std::fstream::in | std::fstream::binary);
+        boost::archive::binary_iarchive ia(infile);
+
+        ia >> blockEnds >> blockStreams;
+        infile.close();
+
+        decodedBlock.clear();
+        decodedBlockIndex = blockEnds.size();
+        return true;
+    }
+
+    template<class T>
+    bool XorCompressedColumn<T>::supportsConcurrentReads() const throw(){
+        // the decoded block is cached by operator[]
+        return false;
+    }
+
+    template<class T>
+    bool XorCompressedColumn<T>::applyOperation(ColumnAlgebraOperation op, const T& operand){
+        for(unsigned int block = 0; block < blockEnds.size(); block++) {
+            decodeBlock(block);
+            apply_operation(&decodedBlock[0], decodedBlock.size(), op, operand);
+            encodeBlock(block);
+        }
+        return true;
+    }
+
+    template<class T>
+    T& XorCompressedColumn<T>::operator[](const int index){
+        // The reference points into the block cache, it stays valid until another block is accessed.
+        TID tid = index;
+        if(decodedBlockIndex >= blockEnds.size() || tid < getBlockStart(decodedBlockIndex) || tid >= blockEnds[decodedBlockIndex]) {
+            decodeBlock(findBlock(tid));
+        }
+        return decodedBlock[tid - getBlockStart(decodedBlockIndex)];
+    }
+
+    template<class T>
+    void XorCompressedColumn<T>::decode(TID begin, TID end, T* out){
+        for(unsigned int block = findBlock(begin); begin < end; block++) {
+            decodeBlock(block);
+            TID blockStart = getBlockStart(block);
+            TID blockEnd = std::min(blockEnds[block], end);
+            out = std::copy(decodedBlock.begin() + (begin - blockStart), decodedBlock.begin() + (blockEnd - blockStart), out);
+            begin = blockEnd;
+        }
+    }
+
+    template<class T>
+    void XorCompressedColumn<T>::gather(const TID* tids, size_t count, T* out){
+        // consecutive TIDs of the same block are served from the block cache, without a virtual call per row
+        for(size_t i = 0; i < count; i++) {
+            out[i] = XorCompressedColumn<T>::operator[](tids[i]);
+        }
+    }
+
+    template<class T>
+    unsigned int XorCompressedColumn<T>::getSizeinBytes() const throw(){
+        unsigned int size = blockEnds.capacity() * sizeof(TID);
+        for(unsigned int i = 0; i < blockStreams.size(); i++) {
+            size += blockStreams[i].getSizeinBytes();
+        }
+        return size;
+    }
+
+/***************** End of Implementation Section ******************/
+
+
+
+}; //end namespace CogaDB
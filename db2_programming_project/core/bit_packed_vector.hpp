@@ -0,0 +1,168 @@
+#pragma once
+
+#include <vector>
+#include <boost/cstdint.hpp>
+#include <boost/serialization/access.hpp>
+#include <boost/serialization/vector.hpp>
+#include <core/global_definitions.hpp>
+#include <core/simd_kernels.hpp>
+
+namespace CoGaDB{
+
+/*!
+ *  \brief     A BitPackedVector stores unsigned integers with a fixed number of bits per value (0 to 64), packed into 64 bit words.
+ *  \details   Value i occupies bits [i*b, (i+1)*b) of the word array, where b is the current number of bits per value. Appending or
+ *             setting a value that does not fit widens all values (the array is repacked), so the width always covers the
+ *             largest value stored so far. The word array always ends with one padding word, which allows the SIMD unpack kernels
+ *             to read a few bytes behind the last value.
+ */
+class BitPackedVector{
+public:
+	/***************** constructors and destructor *****************/
+	/*! \brief creates an empty vector, which uses bits_per_value bits per value until a larger value is stored*/
+	explicit BitPackedVector(unsigned int bits_per_value=0);
+
+	/***************** methods *****************/
+	/*! \brief returns value number index*/
+	inline boost::uint64_t get(size_t index) const;
+	/*! \brief overwrites value number index*/
+	void set(size_t index, boost::uint64_t value);
+	/*! \brief appends a value to the end of the vector*/
+	void push_back(boost::uint64_t value);
+	/*! \brief inserts a value before value number index, all following values move one position to the back*/
+	void insert(size_t index, boost::uint64_t value);
+	/*! \brief removes value number index, all following values move one position to the front*/
+	void erase(size_t index);
+	void clear();
+	inline size_t size() const;
+	/*! \brief returns the number of bits currently used per value*/
+	inline unsigned int getBitsPerValue() const;
+	/*! \brief decodes count values starting at value number begin into out using the SIMD unpack kernels (requires at most 32 bits per value)*/
+	inline void unpack(size_t begin, size_t count, boost::uint32_t* out) const;
+	/*! \brief returns the size in bytes the vector consumes in main memory*/
+	size_t getSizeinBytes() const;
+	/*! \brief repacks all values with bits_per_value bits per value, which has to cover the largest stored value*/
+	void repack(unsigned int bits_per_value);
+
+	/*! \brief returns the number of bits required to represent value*/
+	static unsigned int bitsRequired(boost::uint64_t value);
+
+private:
+	friend class boost::serialization::access;
+	template<class Archive>
+	void serialize(Archive& ar, const unsigned int){
+		ar & words_;
+		ar & bits_per_value_;
+		ar & size_;
+	}
+
+	/*! \brief writes value without checking its width*/
+	inline void write(size_t index, boost::uint64_t value);
+	/*! \brief makes sure the word array holds number_of_values values plus the padding word*/
+	void reserveWords(size_t number_of_values);
+
+	std::vector<boost::uint64_t> words_;
+	unsigned int bits_per_value_;
+	size_t size_;
+};
+
+
+/***************** Start of Implementation Section ******************/
+
+	inline BitPackedVector::BitPackedVector(unsigned int bits_per_value) : words_(1, 0), bits_per_value_(bits_per_value), size_(0){
+
+	}
+
+	inline boost::uint64_t BitPackedVector::get(size_t index) const{
+		return read_packed_value(&words_[0], index, bits_per_value_);
+	}
+
+	inline void BitPackedVector::write(size_t index, boost::uint64_t value){
+		if(bits_per_value_==0) return;
+		boost::uint64_t mask = (bits_per_value_==64) ? ~boost::uint64_t(0) : (boost::uint64_t(1) << bits_per_value_) - 1;
+		boost::uint64_t first_bit = boost::uint64_t(index)*bits_per_value_;
+		size_t word = first_bit/64;
+		unsigned int shift = first_bit%64;
+		words_[word] = (words_[word] & ~(mask << shift)) | (value << shift);
+		if(shift+bits_per_value_>64){
+			//the value continues in the next word
+			words_[word+1] = (words_[word+1] & ~(mask >> (64-shift))) | (value >> (64-shift));
+		}
+	}
+
+	inline void BitPackedVector::set(size_t index, boost::uint64_t value){
+		if(bitsRequired(value)>bits_per_value_) repack(bitsRequired(value));
+		write(index, value);
+	}
+
+	inline void BitPackedVector::push_back(boost::uint64_t value){
+		if(bitsRequired(value)>bits_per_value_) repack(bitsRequired(value));
+		reserveWords(size_+1);
+		write(size_, value);
+		size_++;
+	}
+
+	inline void BitPackedVector::insert(size_t index, boost::uint64_t value){
+		if(bitsRequired(value)>bits_per_value_) repack(bitsRequired(value));
+		reserveWords(size_+1);
+		for(size_t i = size_; i > index; i--){
+			write(i, get(i-1));
+		}
+		write(index, value);
+		size_++;
+	}
+
+	inline void BitPackedVector::erase(size_t index){
+		for(size_t i = index; i+1 < size_; i++){
+			write(i, get(i+1));
+		}
+		write(size_-1, 0);
+		size_--;
+	}
+
+	inline void BitPackedVector::clear(){
+		std::vector<boost::uint64_t>(1, 0).swap(words_);
+		size_ = 0;
+	}
+
+	inline size_t BitPackedVector::size() const{
+		return size_;
+	}
+
+	inline unsigned int BitPackedVector::getBitsPerValue() const{
+		return bits_per_value_;
+	}
+
+	inline void BitPackedVector::unpack(size_t begin, size_t count, boost::uint32_t* out) const{
+		unpack_bits(&words_[0], begin, count, bits_per_value_, out);
+	}
+
+	inline size_t BitPackedVector::getSizeinBytes() const{
+		return words_.capacity()*sizeof(boost::uint64_t);
+	}
+
+	inline void BitPackedVector::repack(unsigned int bits_per_value){
+		BitPackedVector repacked(bits_per_value);
+		repacked.reserveWords(size_);
+		for(size_t i = 0; i < size_; i++){
+			repacked.write(i, get(i));
+		}
+		repacked.size_ = size_;
+		words_.swap(repacked.words_);
+		bits_per_value_ = bits_per_value;
+	}
+
+	inline void BitPackedVector::reserveWords(size_t number_of_values){
+		size_t required_words = (boost::uint64_t(number_of_values)*bits_per_value_ + 63)/64 + 1;
+		if(words_.size()<required_words){
+			words_.resize(required_words, 0);
+		}
+	}
+
+	inline unsigned int BitPackedVector::bitsRequired(boost::uint64_t value){
+		return (value==0) ? 0 : 64 - __builtin_clzll(value);
+	}
+
+/***************** End of Implementation Section ******************/
+
+}; //end namespace CogaDB
@@ -0,0 +1,238 @@
+#pragma once
+
+#include <vector>
+#include <boost/cstdint.hpp>
+#include <boost/serialization/access.hpp>
+#include <boost/serialization/vector.hpp>
+#include <core/global_definitions.hpp>
+
+namespace CoGaDB{
+
+/*!
+ *  \brief     A Bitmap is a growable sequence of bits, which are packed into 64 bit words.
+ *  \details   Bit i is stored in word i/64 at bit position i%64. Counting uses the popcount instruction of the processor,
+ *             so it processes 64 bits per instruction. All bits beyond size() in the last word are kept zero.
+ */
+class Bitmap{
+public:
+	/***************** constructors and destructor *****************/
+	Bitmap();
+	/*! \brief creates a bitmap of number_of_bits bits, which are all zero*/
+	explicit Bitmap(size_t number_of_bits);
+
+	/***************** methods *****************/
+	/*! \brief appends a bit to the end of the bitmap*/
+	inline void push_back(bool bit);
+	/*! \brief appends the lowest count bits of bits (count<=64) to the end of the bitmap, higher bits have to be zero*/
+	inline void append(boost::uint64_t bits, unsigned int count);
+	/*! \brief returns count bits (count<=64) starting at position pos as integer, the bit on position pos is the lowest bit*/
+	inline boost::uint64_t read(size_t pos, unsigned int count) const;
+	/*! \brief returns the bit on position pos*/
+	inline bool test(size_t pos) const;
+	/*! \brief sets the bit on position pos to one*/
+	inline void set(size_t pos);
+	/*! \brief sets the bit on position pos to zero*/
+	inline void reset(size_t pos);
+	/*! \brief sets the bits on the positions [begin, end) to one, whole words are set at once*/
+	void setRange(size_t begin, size_t end);
+	/*! \brief sets the bits on the positions [begin, end) to zero, whole words are cleared at once*/
+	void resetRange(size_t begin, size_t end);
+	/*! \brief removes the bit on position pos, all following bits move one position to the front*/
+	void erase(size_t pos);
+	/*! \brief removes all bits*/
+	void clear();
+	/*! \brief returns the number of bits in the bitmap*/
+	inline size_t size() const;
+	/*! \brief returns the number of bits set to one*/
+	size_t count() const;
+	/*! \brief returns true in case no bit is set to one*/
+	bool none() const;
+	/*! \brief returns the size in bytes the bitmap consumes in main memory*/
+	size_t getSizeinBytes() const;
+	/*! \brief returns the packed words of the bitmap*/
+	const std::vector<boost::uint64_t>& getWords() const;
+	/*! \brief bitwise AND with a bitmap of the same size*/
+	Bitmap& operator&=(const Bitmap& bitmap);
+	/*! \brief bitwise OR with a bitmap of the same size*/
+	Bitmap& operator|=(const Bitmap& bitmap);
+	/*! \brief clears all bits that are set in a bitmap of the same size*/
+	Bitmap& andNot(const Bitmap& bitmap);
+
+private:
+	friend class boost::serialization::access;
+	template<class Archive>
+	void serialize(Archive& ar, const unsigned int){
+		ar & words_;
+		ar & number_of_bits_;
+	}
+
+	/*! \brief packed bits*/
+	std::vector<boost::uint64_t> words_;
+	/*! \brief number of valid bits in words_*/
+	size_t number_of_bits_;
+};
+
+
+/***************** Start of Implementation Section ******************/
+
+	inline Bitmap::Bitmap() : words_(), number_of_bits_(0){
+
+	}
+
+	inline Bitmap::Bitmap(size_t number_of_bits) : words_((number_of_bits+63)/64, 0), number_of_bits_(number_of_bits){
+
+	}
+
+	inline void Bitmap::push_back(bool bit){
+		if(number_of_bits_%64==0){
+			words_.push_back(0);
+		}
+		if(bit){
+			words_.back() |= boost::uint64_t(1) << (number_of_bits_%64);
+		}
+		number_of_bits_++;
+	}
+
+	inline void Bitmap::append(boost::uint64_t bits, unsigned int count){
+		if(count==0) return;
+		unsigned int offset = number_of_bits_%64;
+		if(offset==0){
+			words_.push_back(0);
+		}
+		words_.back() |= bits << offset;
+		if(offset+count>64){
+			//the bits continue in the next word
+			words_.push_back(bits >> (64-offset));
+		}
+		number_of_bits_ += count;
+	}
+
+	inline boost::uint64_t Bitmap::read(size_t pos, unsigned int count) const{
+		if(count==0) return 0;
+		unsigned int shift = pos%64;
+		boost::uint64_t value = words_[pos/64] >> shift;
+		if(shift+count>64){
+			value |= words_[pos/64+1] << (64-shift);
+		}
+		if(count<64){
+			value &= (boost::uint64_t(1) << count) - 1;
+		}
+		return value;
+	}
+
+	inline bool Bitmap::test(size_t pos) const{
+		return (words_[pos/64] >> (pos%64)) & 1;
+	}
+
+	inline void Bitmap::set(size_t pos){
+		words_[pos/64] |= boost::uint64_t(1) << (pos%64);
+	}
+
+	inline void Bitmap::reset(size_t pos){
+		words_[pos/64] &= ~(boost::uint64_t(1) << (pos%64));
+	}
+
+	inline void Bitmap::erase(size_t pos){
+		size_t word = pos/64;
+		boost::uint64_t low_mask = (boost::uint64_t(1) << (pos%64)) - 1;
+		//keep the bits in front of pos, shift the bits behind pos one position down
+		words_[word] = (words_[word] & low_mask) | ((words_[word] >> 1) & ~low_mask);
+		for(size_t i = word + 1; i < words_.size(); i++){
+			//the lowest bit of the next word becomes the highest bit of the previous one
+			words_[i-1] |= words_[i] << 63;
+			words_[i] >>= 1;
+		}
+		number_of_bits_--;
+		if(number_of_bits_%64==0){
+			words_.pop_back();
+		}
+	}
+
+	inline void Bitmap::setRange(size_t begin, size_t end){
+		if(begin>=end) return;
+		size_t first = begin/64, last = (end-1)/64;
+		boost::uint64_t first_mask = ~boost::uint64_t(0) << (begin%64);
+		boost::uint64_t last_mask = ~boost::uint64_t(0) >> (63 - (end-1)%64);
+		if(first==last){
+			words_[first] |= first_mask & last_mask;
+			return;
+		}
+		words_[first] |= first_mask;
+		for(size_t i = first + 1; i < last; i++){
+			words_[i] = ~boost::uint64_t(0);
+		}
+		words_[last] |= last_mask;
+	}
+
+	inline void Bitmap::resetRange(size_t begin, size_t end){
+		if(begin>=end) return;
+		size_t first = begin/64, last = (end-1)/64;
+		boost::uint64_t first_mask = ~boost::uint64_t(0) << (begin%64);
+		boost::uint64_t last_mask = ~boost::uint64_t(0) >> (63 - (end-1)%64);
+		if(first==last){
+			words_[first] &= ~(first_mask & last_mask);
+			return;
+		}
+		words_[first] &= ~first_mask;
+		for(size_t i = first + 1; i < last; i++){
+			words_[i] = 0;
+		}
+		words_[last] &= ~last_mask;
+	}
+
+	inline void Bitmap::clear(){
+		words_.clear();
+		number_of_bits_ = 0;
+	}
+
+	inline size_t Bitmap::size() const{
+		return number_of_bits_;
+	}
+
+	inline size_t Bitmap::count() const{
+		size_t counter = 0;
+		for(size_t i = 0; i < words_.size(); i++){
+			counter += __builtin_popcountll(words_[i]);
+		}
+		return counter;
+	}
+
+	inline bool Bitmap::none() const{
+		for(size_t i = 0; i < words_.size(); i++){
+			if(words_[i]) return false;
+		}
+		return true;
+	}
+
+	inline size_t Bitmap::getSizeinBytes() const{
+		return words_.capacity()*sizeof(boost::uint64_t) + sizeof(Bitmap);
+	}
+
+	inline const std::vector<boost::uint64_t>& Bitmap::getWords() const{
+		return words_;
+	}
+
+	inline Bitmap& Bitmap::operator&=(const Bitmap& bitmap){
+		for(size_t i = 0; i < words_.size(); i++){
+			words_[i] &= bitmap.words_[i];
+		}
+		return *this;
+	}
+
+	inline Bitmap& Bitmap::operator|=(const Bitmap& bitmap){
+		for(size_t i = 0; i < words_.size(); i++){
+			words_[i] |= bitmap.words_[i];
+		}
+		return *this;
+	}
+
+	inline Bitmap& Bitmap::andNot(const Bitmap& bitmap){
+		for(size_t i = 0; i < words_.size(); i++){
+			words_[i] &= ~bitmap.words_[i];
+		}
+		return *this;
+	}
+
+/***************** End of Implementation Section ******************/
+
+}; //end namespace CogaDB
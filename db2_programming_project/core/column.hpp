@@ -1,6 +1,7 @@
 #pragma once
 
 #include <core/column_base_typed.hpp>
+#include <core/simd_kernels.hpp>
 #include <iostream>
 #include <fstream>
 
@@ -35,15 +36,28 @@ class Column : public ColumnBaseTyped<T>{
 
 	virtual const ColumnPtr copy() const;
 
+	/*! \brief sorts the contiguous values directly, without copying them through operator[]*/
+	virtual const PositionListPtr sort(SortOrder order);
+	/*! \brief scans the contiguous values with the compare kernels of simd_kernels.hpp (SIMD for int and float) instead of operator[]*/
+	virtual const PositionListPtr selection(const boost::any& value_for_comparison, const ValueComparator comp);
+
 	virtual bool store(const std::string& path);
 	virtual bool load(const std::string& path);
 	virtual bool isMaterialized() const  throw();
 	virtual bool isCompressed() const  throw();	
 	
 	virtual T& operator[](const int index);
+	virtual void decode(TID begin, TID end, T* out);
+	virtual void gather(const TID* tids, size_t count, T* out);
 
 	std::vector<T>& getContent();
 
+	protected:
+	/*! \brief computes the new values in place with the SIMD kernels of simd_kernels.hpp*/
+	virtual bool applyOperation(ColumnAlgebraOperation op, const T& operand);
+	virtual void replaceContent(const std::vector<T>& values);
+	virtual void selectMorsel(const T& value, const ValueComparator comp, TID begin, TID end, PositionList& result);
+
 	private:
 
 		struct Type_TID_Comparator {
@@ -229,6 +243,39 @@ class Column : public ColumnBaseTyped<T>{
 
 //		return std::vector<TID_Pair>();
 //	}
+	template<class T>
+	const PositionListPtr Column<T>::sort(SortOrder order){
+		if(order!=ASCENDING && order!=DESCENDING){
+			return ColumnBaseTyped<T>::sort(order);
+		}
+		PositionListPtr ids(new PositionList());
+		if(!values_.empty()){
+			sort_values(&values_[0], values_.size(), order, *ids);
+		}
+		return ids;
+	}
+
+	template<class T>
+	const PositionListPtr Column<T>::selection(const boost::any& value_for_comparison, const ValueComparator comp){
+		if(value_for_comparison.type()!=typeid(T)){
+			std::cout << "Fatal Error!!! Typemismatch for column " << this->name_ << std::endl;
+			std::cout << "File: " << __FILE__ << " Line: " << __LINE__ << std::endl;
+			exit(-1);
+		}
+		T value = boost::any_cast<T>(value_for_comparison);
+
+		PositionListPtr result_tids(new PositionList());
+		if(!values_.empty()){
+			select_values(&values_[0], values_.size(), comp, value, 0, *result_tids);
+		}
+		return result_tids;
+	}
+
+	template<class T>
+	void Column<T>::selectMorsel(const T& value, const ValueComparator comp, TID begin, TID end, PositionList& result){
+		select_values(&values_[begin], end-begin, comp, value, begin, result);
+	}
+
 	template<class T>
 	bool Column<T>::store(const std::string& path_){
 		//string path("data/");
@@ -278,6 +325,31 @@ class Column : public ColumnBaseTyped<T>{
 		return values_[index];
 	}
 
+	template<class T>
+	bool Column<T>::applyOperation(ColumnAlgebraOperation op, const T& operand){
+		if(!values_.empty()){
+			apply_operation(&values_[0], values_.size(), op, operand);
+		}
+		return true;
+	}
+
+	template<class T>
+	void Column<T>::replaceContent(const std::vector<T>& values){
+		values_ = values;
+	}
+
+	template<class T>
+	void Column<T>::decode(TID begin, TID end, T* out){
+		std::copy(values_.begin()+begin, values_.begin()+end, out);
+	}
+
+	template<class T>
+	void Column<T>::gather(const TID* tids, size_t count, T* out){
+		for(size_t i=0;i<count;i++){
+			out[i] = values_[tids[i]];
+		}
+	}
+
 	template<class T>
 	unsigned int Column<T>::getSizeinBytes() const throw(){
 			return values_.capacity()*sizeof(T);
@@ -286,7 +358,8 @@ class Column : public ColumnBaseTyped<T>{
 	//total template specialization
 	template<>
 	inline unsigned int Column<std::string>::getSizeinBytes() const throw(){
-		unsigned int size_in_bytes=0;
+		//the string objects themselves plus their heap allocated characters
+		unsigned int size_in_bytes=values_.capacity()*sizeof(std::string);
 		for(unsigned int i=0;i<values_.size();++i){
 			size_in_bytes+=values_[i].capacity();
 		}
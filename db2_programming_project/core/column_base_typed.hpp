@@ -2,6 +2,10 @@
 #pragma once
 
 #include <core/base_column.hpp>
+#include <core/parallel.hpp>
+#include <core/sort_algorithms.hpp>
+#include <core/hash_join.hpp>
+#include <core/simd_kernels.hpp>
 #include <iostream>
 
 #include <utility>
@@ -16,6 +20,9 @@
 /*! \brief The global namespace of the programming tasks, to avoid name claches with other libraries.*/
 namespace CoGaDB{
 
+/*! \brief number of values the generic algorithms decode at once, 1024 values of up to 32 bytes stay in the L1 and L2 cache*/
+const size_t DECODE_BATCH_SIZE = 1024;
+
 /*!
  * 
  * 
@@ -57,7 +64,11 @@ class ColumnBaseTyped : public ColumnBase{
 	/***************** relational operations on Columns which return lookup tables *****************/
 	virtual const PositionListPtr sort(SortOrder order); 
 	virtual const PositionListPtr selection(const boost::any& value_for_comparison, const ValueComparator comp);
+	/*! \brief morsel driven selection with number_of_threads threads, see parallel.hpp
+	 *  \details Falls back to selection() for small columns and for columns that do not support concurrent reads.*/
 	virtual const PositionListPtr parallel_selection(const boost::any& value_for_comparison, const ValueComparator comp, unsigned int number_of_threads);
+	/*! \brief returns true in case several threads may read the column at once, i.e., operator[] does not modify the column (e.g., a decode cache)*/
+	virtual bool supportsConcurrentReads() const throw();
 	//join algorithms
 	virtual const PositionListPairPtr hash_join(ColumnPtr join_column);
 	virtual const PositionListPairPtr sort_merge_join(ColumnPtr join_column);
@@ -92,6 +103,30 @@ class ColumnBaseTyped : public ColumnBase{
 	 * */
 	virtual T& operator[](const int index) = 0;
 	inline bool operator==(ColumnBaseTyped<T>& column);
+	/*! \brief writes the values of the rows [begin, end) to out, which has to provide space for end-begin values
+	 *  \details The default implementation calls operator[] for every row, derived classes decode whole blocks or runs at once.
+	 *           Has to be safe to call from several threads at once in case supportsConcurrentReads() returns true.*/
+	virtual void decode(TID begin, TID end, T* out);
+	/*! \brief writes the values of the rows tids[0], ..., tids[count-1] (e.g., a part of a PositionList) to out, which has to provide space for count values*/
+	virtual void gather(const TID* tids, size_t count, T* out);
+
+	protected:
+	/*! \brief decodes all rows into values*/
+	void materialize(std::vector<T>& values);
+	/*! \brief replaces the value of every row by value op operand, is called by add(), minus(), multiply() and division() with a constant
+	 *  \details The default implementation decodes all rows, computes the new values with the kernels of simd_kernels.hpp and
+	 *           inserts them again. Derived classes change their values in place, compressed columns only their distinct values,
+	 *           run values or reference values.*/
+	virtual bool applyOperation(ColumnAlgebraOperation op, const T& operand);
+	/*! \brief replaces the value of every row by value op the value of the same row of column, is called by add(), minus(),
+	 *         multiply() and division() with a column
+	 *  \details Returns false in case column is NULL, has another type or size, or contains a zero divisor. The rows are combined
+	 *           in batches of DECODE_BATCH_SIZE values and the result is stored with replaceContent().*/
+	bool applyColumnOperation(ColumnAlgebraOperation op, ColumnPtr column);
+	/*! \brief replaces all rows by values, the default implementation clears the column and inserts the values again*/
+	virtual void replaceContent(const std::vector<T>& values);
+	/*! \brief appends the TIDs in [begin, end) fulfilling the predicate to result, is called by several threads at once during parallel_selection()*/
+	virtual void selectMorsel(const T& value, const ValueComparator comp, TID begin, TID end, PositionList& result);
 };
 
 
@@ -114,38 +149,113 @@ template<class T>
 const PositionListPtr ColumnBaseTyped<T>::sort(SortOrder order){
 
 	PositionListPtr ids = PositionListPtr( new PositionList());
-		std::vector<std::pair<T,TID> > v;
+		if(order!=ASCENDING && order!=DESCENDING){
+			std::cout << "FATAL ERROR: ColumnBaseTyped<T>::sort(): Unknown Sorting Order!" << std::endl;
+			return ids;
+		}
 
-		for(unsigned int i=0;i<this->size();i++){
-			v.push_back (std::pair<T,TID>((*this)[i],i) );
+		std::vector<T> values;
+		this->materialize(values);
+
+		//radix sort for int and float, parallel merge sort of (value,TID) pairs for other types, see sort_algorithms.hpp
+		if(!values.empty()){
+			sort_values(&values[0],values.size(),order,*ids);
 		}
 
-		//TODO: change implementation, so that no copy operations are required -> use boost zip iterators!
+		return ids;
+}
 
-	  	if(order==ASCENDING){
-			//tbb::parallel_sort(v.begin(),v.end(),std::less_equal<std::pair<T,TID> >());
-	  		std::stable_sort(v.begin(),v.end(),std::less_equal<std::pair<T,TID> >());
-		}else if(order==DESCENDING){
-			//tbb::parallel_sort(v.begin(),v.end(),std::greater_equal<std::pair<T,TID> >());
-			std::stable_sort(v.begin(),v.end(),std::greater_equal<std::pair<T,TID> >()); 
-		}else{
-			std::cout << "FATAL ERROR: ColumnBaseTyped<T>::sort(): Unknown Sorting Order!" << std::endl;
+
+template<class T>
+const PositionListPtr ColumnBaseTyped<T>::parallel_selection(const boost::any& value_for_comparison, const ValueComparator comp, unsigned int number_of_threads){
+		if(value_for_comparison.type()!=typeid(T)){
+			std::cout << "Fatal Error!!! Typemismatch for column " << name_ << std::endl;
+			std::cout << "File: " << __FILE__ << " Line: " << __LINE__ << std::endl;
+			exit(-1);
 		}
+		if(number_of_threads<=1 || this->size()<=MORSEL_SIZE || !this->supportsConcurrentReads()){
+			return this->selection(value_for_comparison, comp);
+		}
+
+		T value = boost::any_cast<T>(value_for_comparison);
+		return parallel_scan(this->size(), number_of_threads,
+			boost::bind(&ColumnBaseTyped<T>::selectMorsel, this, value, comp, boost::placeholders::_1, boost::placeholders::_2, boost::placeholders::_3));
+}
 
-		for(unsigned int i=0;i<v.size();i++){
-			ids->push_back(v[i].second);
+template<class T>
+bool ColumnBaseTyped<T>::supportsConcurrentReads() const throw(){
+		return true;
+}
+
+template<class T>
+void ColumnBaseTyped<T>::selectMorsel(const T& value, const ValueComparator comp, TID begin, TID end, PositionList& result){
+		std::vector<T> values(std::min<size_t>(end-begin, DECODE_BATCH_SIZE));
+		for(TID batch_begin=begin;batch_begin<end;batch_begin+=DECODE_BATCH_SIZE){
+			TID batch_end=std::min<TID>(batch_begin+DECODE_BATCH_SIZE, end);
+			this->decode(batch_begin, batch_end, &values[0]);
+			select_values(&values[0], batch_end-batch_begin, comp, value, batch_begin, result);
 		}
+}
 
-		return ids;
+template<class T>
+void ColumnBaseTyped<T>::decode(TID begin, TID end, T* out){
+		for(TID i=begin;i<end;i++){
+			*out++ = (*this)[i];
+		}
 }
 
+template<class T>
+void ColumnBaseTyped<T>::gather(const TID* tids, size_t count, T* out){
+		for(size_t i=0;i<count;i++){
+			out[i] = (*this)[tids[i]];
+		}
+}
 
 template<class T>
-const PositionListPtr ColumnBaseTyped<T>::parallel_selection(const boost::any&, const ValueComparator, unsigned int){
+void ColumnBaseTyped<T>::materialize(std::vector<T>& values){
+		values.resize(this->size());
+		if(!values.empty()){
+			this->decode(0, values.size(), &values[0]);
+		}
+}
 
-		PositionListPtr result_tids( new PositionList());
+template<class T>
+bool ColumnBaseTyped<T>::applyOperation(ColumnAlgebraOperation op, const T& operand){
+		std::vector<T> values;
+		this->materialize(values);
+		if(values.empty()) return true;
+		apply_operation(&values[0], values.size(), op, operand);
+		this->replaceContent(values);
+		return true;
+}
 
-		return result_tids;
+template<class T>
+bool ColumnBaseTyped<T>::applyColumnOperation(ColumnAlgebraOperation op, ColumnPtr column){
+		if(!column || column->type()!=typeid(T)) return false;
+		shared_pointer_namespace::shared_ptr<ColumnBaseTyped<T> > typed_column = shared_pointer_namespace::static_pointer_cast<ColumnBaseTyped<T> >(column);
+		if(typed_column->size()!=this->size()) return false;
+
+		//compressed columns share values between rows (dictionaries, runs, decode caches), so the rows are not written through operator[]
+		std::vector<T> values;
+		this->materialize(values);
+		std::vector<T> operands(DECODE_BATCH_SIZE);
+		for(TID begin=0;begin<values.size();begin+=DECODE_BATCH_SIZE){
+			TID end=std::min<TID>(begin+DECODE_BATCH_SIZE, values.size());
+			typed_column->decode(begin, end, &operands[0]);
+			//check that we do not devide by zero, before any row is changed
+			if(op==DIV && std::find(operands.begin(), operands.begin()+(end-begin), T(0))!=operands.begin()+(end-begin)) return false;
+			apply_operation(&values[begin], &operands[0], end-begin, op);
+		}
+		this->replaceContent(values);
+		return true;
+}
+
+template<class T>
+void ColumnBaseTyped<T>::replaceContent(const std::vector<T>& values){
+		this->clearContent();
+		for(unsigned int i=0;i<values.size();i++){
+			this->insert(values[i]);
+		}
 }
 
 
@@ -166,30 +276,10 @@ const PositionListPtr ColumnBaseTyped<T>::selection(const boost::any& value_for_
 				result_tids = PositionListPtr(new PositionList());
 
 				if(!quiet) std::cout << "Using CPU for Selection..." << std::endl;
-				for(TID i=0;i<this->size();i++){
-		
-					//boost::any value = column->get(i);
-					//val = values_[i];
-			
-					if(comp==EQUAL){
-					if(value==(*this)[i]){
-						//result_table->insert(this->fetchTuple(i));
-						result_tids->push_back(i);
-					}
-					}else if(comp==LESSER){
-					if((*this)[i]<value){
-						//result_table->insert(this->fetchTuple(i));
-						result_tids->push_back(i);
-					}
-					}else if(comp==GREATER){
-					if((*this)[i]>value){
-						result_tids->push_back(i);
-						//result_table->insert(this->fetchTuple(i));
-					}
-					}else{
-
-					}
-				}	
+				//decode batches of values and scan them with the compare kernels instead of calling operator[] per row
+				if(this->size()>0){
+					this->selectMorsel(value, comp, 0, this->size(), *result_tids);
+				}
 
 	    //}
 	    return result_tids;
@@ -199,8 +289,6 @@ const PositionListPtr ColumnBaseTyped<T>::selection(const boost::any& value_for_
 	template<class T>
 	const PositionListPairPtr ColumnBaseTyped<T>::hash_join(ColumnPtr join_column_){
 
-		typedef boost::unordered_multimap<T,TID,boost::hash<T>, std::equal_to<T> > HashTable;
-
 				if(join_column_->type()!=typeid(T)){
 					std::cout << "Fatal Error!!! Typemismatch for columns " << this->name_  << " and " << join_column_->getName() << std::endl;
 					std::cout << "File: " << __FILE__ << " Line: " << __LINE__ << std::endl;
@@ -214,24 +302,12 @@ const PositionListPtr ColumnBaseTyped<T>::selection(const boost::any& value_for_
 				join_tids->second = PositionListPtr( new PositionList() );
 
 
-	//create hash table
-	HashTable hashtable;
-	for(unsigned int i=0;i<this->size();i++)	
-		hashtable.insert(
-								std::pair<T,TID> ((*this)[i],i)
-					);
-
-	//probe larger relation
-	for(unsigned int i=0;i<join_column->size();i++){
-		std::pair<typename HashTable::iterator, typename HashTable::iterator> range =  hashtable.equal_range((*join_column)[i]);
-		for(typename HashTable::iterator it=range.first ; it!=range.second;it++){
-			if(it->first==(*join_column)[i]){
-				join_tids->first->push_back(it->second);
-				join_tids->second->push_back(i);
-				//cout << "match! " << it->second << ", " << i << "	"  << it->first << endl;
-			}
-		}
-	}
+	//materialize both inputs, the radix hash join builds on the smaller one (see hash_join.hpp)
+	std::vector<T> left_values;
+	this->materialize(left_values);
+	std::vector<T> right_values;
+	join_column->materialize(right_values);
+	radix_hash_join(left_values, right_values, *join_tids->first, *join_tids->second, get_number_of_threads());
 
 		return join_tids;
 	}
@@ -251,6 +327,53 @@ const PositionListPtr ColumnBaseTyped<T>::selection(const boost::any& value_for_
 				join_tids->first = PositionListPtr( new PositionList() );
 				join_tids->second = PositionListPtr( new PositionList() );
 
+		typedef std::vector<std::pair<Type,TID> > ValueTIDPairs;
+		std::vector<Type> values;
+		this->materialize(values);
+		ValueTIDPairs left;
+		left.reserve(values.size());
+		for(unsigned int i=0;i<values.size();i++){
+			left.push_back(std::pair<Type,TID>(values[i],i));
+		}
+		join_column->materialize(values);
+		ValueTIDPairs right;
+		right.reserve(values.size());
+		for(unsigned int i=0;i<values.size();i++){
+			right.push_back(std::pair<Type,TID>(values[i],i));
+		}
+
+		//the pairs are created in TID order, so a column with ascending values needs no sort phase (one pass instead of O(n log n))
+		if(!is_sorted_ascending(left.begin(),left.end(),std::less<std::pair<Type,TID> >())){
+			parallel_sort(left.begin(),left.end(),std::less<std::pair<Type,TID> >());
+		}
+		if(!is_sorted_ascending(right.begin(),right.end(),std::less<std::pair<Type,TID> >())){
+			parallel_sort(right.begin(),right.end(),std::less<std::pair<Type,TID> >());
+		}
+
+		//merge phase, every run of equal values on the left side is joined with the run of equal values on the right side
+		size_t i=0;
+		size_t j=0;
+		while(i<left.size() && j<right.size()){
+			if(left[i].first<right[j].first){
+				i++;
+			}else if(right[j].first<left[i].first){
+				j++;
+			}else{
+				size_t left_end=i+1;
+				while(left_end<left.size() && !(left[i].first<left[left_end].first)) left_end++;
+				size_t right_end=j+1;
+				while(right_end<right.size() && !(right[j].first<right[right_end].first)) right_end++;
+				for(size_t l=i;l<left_end;l++){
+					for(size_t r=j;r<right_end;r++){
+						join_tids->first->push_back(left[l].second);
+						join_tids->second->push_back(right[r].second);
+					}
+				}
+				i=left_end;
+				j=right_end;
+			}
+		}
+
 				return join_tids;
 	}
 
@@ -270,9 +393,13 @@ const PositionListPtr ColumnBaseTyped<T>::selection(const boost::any& value_for_
 				join_tids->first = PositionListPtr( new PositionList() );
 				join_tids->second = PositionListPtr( new PositionList() );
 
-		for(unsigned int i=0;i<this->size();i++){
-			for(unsigned int j=0;j<join_column->size();j++){
-				if((*this)[i]==(*join_column)[j]){
+		std::vector<Type> left_values;
+		this->materialize(left_values);
+		std::vector<Type> right_values;
+		join_column->materialize(right_values);
+		for(unsigned int i=0;i<left_values.size();i++){
+			for(unsigned int j=0;j<right_values.size();j++){
+				if(left_values[i]==right_values[j]){
 					if(debug) std::cout << "MATCH: (" << i << "," << j << ")" << std::endl;
 					join_tids->first->push_back(i);
 					join_tids->second->push_back(j);
@@ -286,8 +413,13 @@ const PositionListPtr ColumnBaseTyped<T>::selection(const boost::any& value_for_
 	template<class T>
 	bool ColumnBaseTyped<T>::operator==(ColumnBaseTyped<T>& column){
 	  if(this->size()!=column.size()) return false;
-	  for(unsigned int i=0;i<this->size();i++){
-			if((*this)[i]!=column[i]){ 	
+	  std::vector<T> values(DECODE_BATCH_SIZE);
+	  std::vector<T> other_values(DECODE_BATCH_SIZE);
+	  for(TID begin=0;begin<this->size();begin+=DECODE_BATCH_SIZE){
+			TID end=std::min<TID>(begin+DECODE_BATCH_SIZE, this->size());
+			this->decode(begin, end, &values[0]);
+			column.decode(begin, end, &other_values[0]);
+			if(!std::equal(values.begin(), values.begin()+(end-begin), other_values.begin())){
 				return false;
 			}
 	  }
@@ -299,12 +431,7 @@ const PositionListPtr ColumnBaseTyped<T>::selection(const boost::any& value_for_
 		if(new_value.empty()) return false;
 		if(typeid(Type)==new_value.type()){
 			 Type value = boost::any_cast<Type>(new_value);
-			 //std::transform(myvec.begin(), myvec.end(), myvec.begin(),
-          //bind2nd(std::plus<double>(), 1.0));
-			 for(unsigned int i=0;i<this->size();i++){
-					this->operator[](i)+=value;
-			 }
-			 return true;
+			 return this->applyOperation(ADD, value);
 		}
 		return false;
 	}
@@ -314,12 +441,7 @@ const PositionListPtr ColumnBaseTyped<T>::selection(const boost::any& value_for_
 	template<class Type>
 	bool ColumnBaseTyped<Type>::add(ColumnPtr column){
 		//std::transform ( first, first+5, second, results, std::plus<int>() );		
-		shared_pointer_namespace::shared_ptr<ColumnBaseTyped<Type> > typed_column = shared_pointer_namespace::static_pointer_cast<ColumnBaseTyped<Type> >(column);
-		if(!column) return false;
-		for(unsigned int i=0;i<this->size();i++){
-			this->operator[](i)+=typed_column->operator[](i);
-		}			
-		return true;
+		return this->applyColumnOperation(ADD, column);
 	}
 
 
@@ -330,10 +452,7 @@ const PositionListPtr ColumnBaseTyped<T>::selection(const boost::any& value_for_
 		if(new_value.empty()) return false;
 		if(typeid(Type)==new_value.type()){
 			 Type value = boost::any_cast<Type>(new_value);
-			 for(unsigned int i=0;i<this->size();i++){
-					this->operator[](i)-=value;
-			 }
-			 return true;
+			 return this->applyOperation(SUB, value);
 		}
 		return false;
 	}
@@ -341,12 +460,7 @@ const PositionListPtr ColumnBaseTyped<T>::selection(const boost::any& value_for_
 	template<class Type>
 	bool ColumnBaseTyped<Type>::minus(ColumnPtr column){
 		//std::transform ( first, first+5, second, results, std::plus<int>() );		
-		shared_pointer_namespace::shared_ptr<ColumnBaseTyped<Type> > typed_column = shared_pointer_namespace::static_pointer_cast<ColumnBaseTyped<Type> >(column);
-		if(!column) return false;
-		for(unsigned int i=0;i<this->size();i++){
-			this->operator[](i)-=typed_column->operator[](i);
-		}			
-		return true;
+		return this->applyColumnOperation(SUB, column);
 	}	
 
 
@@ -355,10 +469,7 @@ const PositionListPtr ColumnBaseTyped<T>::selection(const boost::any& value_for_
 		if(new_value.empty()) return false;
 		if(typeid(Type)==new_value.type()){
 			 Type value = boost::any_cast<Type>(new_value);
-			 for(unsigned int i=0;i<this->size();i++){
-					this->operator[](i)*=value;
-			 }
-			 return true;
+			 return this->applyOperation(MUL, value);
 		}
 		return false;
 	}
@@ -366,12 +477,7 @@ const PositionListPtr ColumnBaseTyped<T>::selection(const boost::any& value_for_
 	template<class Type>
 	bool ColumnBaseTyped<Type>::multiply(ColumnPtr column){
 		//std::transform ( first, first+5, second, results, std::plus<int>() );		
-		shared_pointer_namespace::shared_ptr<ColumnBaseTyped<Type> > typed_column = shared_pointer_namespace::static_pointer_cast<ColumnBaseTyped<Type> >(column);
-		if(!column) return false;
-		for(unsigned int i=0;i<this->size();i++){
-			this->operator[](i)*=typed_column->operator[](i);
-		}			
-		return true;
+		return this->applyColumnOperation(MUL, column);
 	}
 
 
@@ -383,10 +489,7 @@ const PositionListPtr ColumnBaseTyped<T>::selection(const boost::any& value_for_
 			 Type value = boost::any_cast<Type>(new_value);
 			 //check that we do not devide by zero
 			 if(value==0) return false;
-			 for(unsigned int i=0;i<this->size();i++){
-					this->operator[](i)/=value;
-			 }
-			 return true;
+			 return this->applyOperation(DIV, value);
 		}
 		return false;
 	}
@@ -394,12 +497,7 @@ const PositionListPtr ColumnBaseTyped<T>::selection(const boost::any& value_for_
 	template<class Type>
 	bool ColumnBaseTyped<Type>::division(ColumnPtr column){
 		//std::transform ( first, first+5, second, results, std::plus<int>() );		
-		shared_pointer_namespace::shared_ptr<ColumnBaseTyped<Type> > typed_column = shared_pointer_namespace::static_pointer_cast<ColumnBaseTyped<Type> >(column);
-		if(!column) return false;
-		for(unsigned int i=0;i<this->size();i++){
-			this->operator[](i)/=typed_column->operator[](i);
-		}			
-		return true;
+		return this->applyColumnOperation(DIV, column);
 	}
 
 	//total tempalte specializations, because numeric computations are undefined on strings 
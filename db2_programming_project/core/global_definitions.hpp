@@ -31,6 +31,8 @@ enum MaterializationStatus{MATERIALIZE,LOOKUP};
 
 enum ParallelizationMode{SERIAL,PARALLEL};
 
+enum ColumnAlgebraOperation{ADD,SUB,MUL,DIV};
+
 
 
 enum DebugMode{quiet=1,
@@ -0,0 +1,181 @@
+#pragma once
+
+#include <vector>
+#include <boost/cstdint.hpp>
+#include <boost/functional/hash.hpp>
+#include <boost/thread.hpp>
+#include <boost/atomic.hpp>
+#include <boost/bind/bind.hpp>
+#include <core/base_column.hpp>
+
+namespace CoGaDB{
+
+/*!
+ *  \file hash_join.hpp
+ *  \brief Radix partitioned hash join with open addressing hash tables.
+ *  \details The smaller input is the build side. Both inputs are partitioned by the upper bits of the hash values, so the hash
+ *           table of every build partition fits into the L2 cache. The partitions are joined independently by several threads.
+ *           Each one builds a flat hash table with linear probing, which stores indices into the partition instead of
+ *           allocating a node per row, and probes it with the matching partition of the other input. A distinct key occupies a
+ *           single slot, which refers to a chain of all build rows with this key, so duplicate keys do not lengthen the probe
+ *           sequences.
+ */
+
+/*! \brief number of build rows per partition, a row needs 20 bytes (partition entry, chain link and two table slots), i.e., 320KB per partition*/
+const size_t HASH_JOIN_PARTITION_SIZE = 16384;
+/*! \brief maximal number of radix bits, i.e., at most 4096 partitions*/
+const unsigned int HASH_JOIN_MAX_RADIX_BITS = 12;
+
+/*! \brief a row of a partition: the hash value of the join key and the TID of the row*/
+struct HashJoinEntry{
+	boost::uint32_t hash;
+	TID tid;
+};
+
+/*! \brief returns a 32 bit hash value of value, the boost hash is mixed, because it is the identity for integers*/
+template<class T>
+inline boost::uint32_t get_join_hash(const T& value){
+	boost::uint64_t hash = boost::uint64_t(boost::hash<T>()(value)) * 0x9E3779B97F4A7C15ULL;
+	return boost::uint32_t(hash >> 32);
+}
+
+/*! \brief partitions the rows of values by the upper radix_bits bits of their hash values, the rows of a partition keep their order
+ *  \details partition p consists of entries[bounds[p]] to entries[bounds[p+1]-1].*/
+template<class T>
+void radix_partition(const std::vector<T>& values, unsigned int radix_bits, std::vector<HashJoinEntry>& entries, std::vector<size_t>& bounds){
+	size_t number_of_partitions = size_t(1) << radix_bits;
+	std::vector<boost::uint32_t> hashes(values.size());
+	std::vector<size_t> histogram(number_of_partitions+1, 0);
+	for(size_t i = 0; i < values.size(); i++){
+		hashes[i] = get_join_hash(values[i]);
+		histogram[radix_bits ? (hashes[i] >> (32-radix_bits)) + 1 : 1]++;
+	}
+	for(size_t p = 0; p < number_of_partitions; p++){
+		histogram[p+1] += histogram[p];
+	}
+	bounds = histogram;
+
+	entries.resize(values.size());
+	for(size_t i = 0; i < values.size(); i++){
+		size_t partition = radix_bits ? hashes[i] >> (32-radix_bits) : 0;
+		HashJoinEntry& entry = entries[histogram[partition]++];
+		entry.hash = hashes[i];
+		entry.tid = i;
+	}
+}
+
+/*! \brief joins one partition, appends the pairs (probe TID, build TID) to result in the order of the probe rows*/
+template<class T>
+void join_partition(const std::vector<T>& build_values, const HashJoinEntry* build, size_t build_size,
+					const std::vector<T>& probe_values, const HashJoinEntry* probe, size_t probe_size,
+					std::vector<std::pair<TID,TID> >& result){
+	if(build_size == 0 || probe_size == 0) return;
+
+	//at most half of the slots are used, a slot stores the index of the first build row with its key plus one, zero marks an
+	//empty slot, next links each build row to the following row with the same key (again plus one, zero ends the chain)
+	size_t number_of_slots = 2;
+	while(number_of_slots < 2*build_size) number_of_slots *= 2;
+	size_t mask = number_of_slots - 1;
+	std::vector<boost::uint32_t> slots(number_of_slots, 0);
+	std::vector<boost::uint32_t> next(build_size, 0);
+	//the rows are inserted backwards and prepended to their chain, so a chain lists its rows by ascending TID
+	for(size_t i = build_size; i-- > 0;){
+		const T& value = build_values[build[i].tid];
+		size_t slot = build[i].hash & mask;
+		while(slots[slot]){
+			const HashJoinEntry& first = build[slots[slot]-1];
+			if(first.hash == build[i].hash && build_values[first.tid] == value) break;
+			slot = (slot+1) & mask;
+		}
+		next[i] = slots[slot];
+		slots[slot] = i+1;
+	}
+
+	for(size_t i = 0; i < probe_size; i++){
+		const T& value = probe_values[probe[i].tid];
+		for(size_t slot = probe[i].hash & mask; slots[slot]; slot = (slot+1) & mask){
+			const HashJoinEntry& first = build[slots[slot]-1];
+			if(first.hash == probe[i].hash && build_values[first.tid] == value){
+				for(boost::uint32_t row = slots[slot]; row; row = next[row-1]){
+					result.push_back(std::make_pair(probe[i].tid, build[row-1].tid));
+				}
+				break;
+			}
+		}
+	}
+}
+
+/*! \brief joins the partitions taken from next_partition until none is left*/
+template<class T>
+void join_partitions(const std::vector<T>* build_values, const std::vector<HashJoinEntry>* build, const std::vector<size_t>* build_bounds,
+					 const std::vector<T>* probe_values, const std::vector<HashJoinEntry>* probe, const std::vector<size_t>* probe_bounds,
+					 boost::atomic<size_t>* next_partition, std::vector<std::vector<std::pair<TID,TID> > >* results){
+	size_t p;
+	while((p = next_partition->fetch_add(1)) < results->size()){
+		join_partition(*build_values, &(*build)[0] + (*build_bounds)[p], (*build_bounds)[p+1] - (*build_bounds)[p],
+					   *probe_values, &(*probe)[0] + (*probe_bounds)[p], (*probe_bounds)[p+1] - (*probe_bounds)[p], (*results)[p]);
+	}
+}
+
+/*! \brief equi join of left and right, appends the matching pairs of TIDs to left_tids and right_tids
+ *  \details The pairs are ordered by the TIDs of right and then by the TIDs of left.*/
+template<class T>
+void radix_hash_join(const std::vector<T>& left, const std::vector<T>& right, PositionList& left_tids, PositionList& right_tids, unsigned int number_of_threads){
+	if(left.empty() || right.empty()) return;
+
+	bool build_on_left = left.size() <= right.size();
+	const std::vector<T>& build_values = build_on_left ? left : right;
+	const std::vector<T>& probe_values = build_on_left ? right : left;
+
+	unsigned int radix_bits = 0;
+	while(radix_bits < HASH_JOIN_MAX_RADIX_BITS && (build_values.size() >> radix_bits) > HASH_JOIN_PARTITION_SIZE) radix_bits++;
+
+	std::vector<HashJoinEntry> build;
+	std::vector<size_t> build_bounds;
+	radix_partition(build_values, radix_bits, build, build_bounds);
+	std::vector<HashJoinEntry> probe;
+	std::vector<size_t> probe_bounds;
+	radix_partition(probe_values, radix_bits, probe, probe_bounds);
+
+	std::vector<std::vector<std::pair<TID,TID> > > results(size_t(1) << radix_bits);
+	if(number_of_threads > results.size()){
+		number_of_threads = results.size();
+	}
+	boost::atomic<size_t> next_partition(0);
+	boost::thread_group threads;
+	//the calling thread is one of the workers
+	for(unsigned int i = 1; i < number_of_threads; i++){
+		threads.create_thread(boost::bind(&join_partitions<T>, &build_values, &build, &build_bounds, &probe_values, &probe, &probe_bounds, &next_partition, &results));
+	}
+	join_partitions<T>(&build_values, &build, &build_bounds, &probe_values, &probe, &probe_bounds, &next_partition, &results);
+	threads.join_all();
+
+	//order the pairs by the TIDs of right with a counting sort, all matches of a right row come from the same partition in
+	//ascending order of the left TIDs, so this order is kept
+	std::vector<size_t> offsets(right.size()+1, 0);
+	size_t number_of_pairs = 0;
+	for(size_t p = 0; p < results.size(); p++){
+		for(size_t i = 0; i < results[p].size(); i++){
+			offsets[(build_on_left ? results[p][i].first : results[p][i].second) + 1]++;
+		}
+		number_of_pairs += results[p].size();
+	}
+	for(size_t i = 0; i < right.size(); i++){
+		offsets[i+1] += offsets[i];
+	}
+
+	size_t first_pair = left_tids.size();
+	left_tids.resize(first_pair + number_of_pairs);
+	right_tids.resize(first_pair + number_of_pairs);
+	for(size_t p = 0; p < results.size(); p++){
+		for(size_t i = 0; i < results[p].size(); i++){
+			TID left_tid = build_on_left ? results[p][i].second : results[p][i].first;
+			TID right_tid = build_on_left ? results[p][i].first : results[p][i].second;
+			size_t position = first_pair + offsets[right_tid]++;
+			left_tids[position] = left_tid;
+			right_tids[position] = right_tid;
+		}
+	}
+}
+
+}; //end namespace CogaDB
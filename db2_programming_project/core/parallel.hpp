@@ -0,0 +1,66 @@
+#pragma once
+
+#include <vector>
+#include <algorithm>
+#include <boost/thread.hpp>
+#include <boost/atomic.hpp>
+#include <boost/bind/bind.hpp>
+#include <core/base_column.hpp>
+
+namespace CoGaDB{
+
+/*!
+ *  \file parallel.hpp
+ *  \brief Morsel driven scheduling of parallel scans.
+ *  \details A scan over a range of items (rows or runs) is split into morsels of a fixed number of items. Every worker thread
+ *           takes the next unprocessed morsel from a shared atomic counter until no morsel is left, so threads that hit
+ *           expensive morsels simply process fewer of them. Each morsel writes its TIDs into its own PositionList, which are
+ *           concatenated in morsel order at the end, so the result is sorted and no lock is needed.
+ */
+
+/*! \brief default number of items per morsel, 16384 values of four bytes (64KB) and their TIDs stay in the L2 cache*/
+const size_t MORSEL_SIZE = 16384;
+
+/*! \brief processes morsels until the counter passes the last one, function(begin, end, result) scans the items in [begin, end)*/
+template<class MorselFunction>
+void process_morsels(const MorselFunction& function, size_t number_of_items, size_t morsel_size, boost::atomic<size_t>* next_morsel, std::vector<PositionList>* results){
+	size_t morsel;
+	while((morsel = next_morsel->fetch_add(1)) < results->size()){
+		size_t begin = morsel*morsel_size;
+		size_t end = std::min(begin+morsel_size, number_of_items);
+		function(begin, end, (*results)[morsel]);
+	}
+}
+
+/*! \brief scans number_of_items items with number_of_threads threads and returns the concatenated TIDs of all morsels
+ *  \details function(begin, end, result) has to append the TIDs found in the items [begin, end) to result and must be safe to
+ *           call from several threads at once.*/
+template<class MorselFunction>
+const PositionListPtr parallel_scan(size_t number_of_items, unsigned int number_of_threads, const MorselFunction& function, size_t morsel_size = MORSEL_SIZE){
+	std::vector<PositionList> results((number_of_items+morsel_size-1)/morsel_size);
+	if(number_of_threads>results.size()){
+		number_of_threads = results.size();
+	}
+
+	boost::atomic<size_t> next_morsel(0);
+	boost::thread_group threads;
+	//the calling thread is one of the workers
+	for(unsigned int i = 1; i < number_of_threads; i++){
+		threads.create_thread(boost::bind(&process_morsels<MorselFunction>, boost::cref(function), number_of_items, morsel_size, &next_morsel, &results));
+	}
+	process_morsels(function, number_of_items, morsel_size, &next_morsel, &results);
+	threads.join_all();
+
+	size_t number_of_tids = 0;
+	for(size_t i = 0; i < results.size(); i++){
+		number_of_tids += results[i].size();
+	}
+	PositionListPtr result_tids(new PositionList());
+	result_tids->reserve(number_of_tids);
+	for(size_t i = 0; i < results.size(); i++){
+		result_tids->insert(result_tids->end(), results[i].begin(), results[i].end());
+	}
+	return result_tids;
+}
+
+}; //end namespace CogaDB
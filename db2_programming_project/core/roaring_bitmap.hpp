@@ -0,0 +1,773 @@
+#pragma once
+
+#include <vector>
+#include <algorithm>
+#include <iterator>
+#include <boost/cstdint.hpp>
+#include <boost/serialization/access.hpp>
+#include <boost/serialization/vector.hpp>
+#include <core/global_definitions.hpp>
+#include <core/bitmap.hpp>
+
+namespace CoGaDB{
+
+/*!
+ *  \brief     A RoaringContainer stores the lower 16 bits of all positions of a RoaringBitmap that share the same upper 16 bits.
+ *  \details   Depending on the data, a container is either a sorted array of values (sparse chunks), a Bitmap of 65536 bits
+ *             (dense chunks) or a sorted list of runs (clustered chunks). Array and bitset containers are switched automatically
+ *             at a cardinality of MAX_ARRAY_CARDINALITY, run containers are only created by runOptimize() and by boolean operations
+ *             on run containers, whose results are run optimized.
+ */
+class RoaringContainer{
+public:
+	enum ContainerType{ARRAY_CONTAINER,BITSET_CONTAINER,RUN_CONTAINER};
+	/*! \brief an array container with more values than this is converted into a bitset container*/
+	static const boost::uint32_t MAX_ARRAY_CARDINALITY = 4096;
+	/*! \brief number of positions covered by one container*/
+	static const boost::uint32_t CHUNK_SIZE = 65536;
+
+	/***************** constructors and destructor *****************/
+	RoaringContainer();
+
+	/***************** methods *****************/
+	void add(boost::uint16_t value);
+	void remove(boost::uint16_t value);
+	bool contains(boost::uint16_t value) const;
+	boost::uint32_t cardinality() const;
+	/*! \brief converts the container into the representation with the smallest memory footprint, including run containers*/
+	void runOptimize();
+	/*! \brief appends all positions of this container to result in ascending order, high_bits are the upper 16 bits*/
+	void appendPositions(boost::uint32_t high_bits, std::vector<TID>& result) const;
+	/*! \brief appends the positions in [begin, end) of this container to result in ascending order, end may be CHUNK_SIZE*/
+	void appendPositions(boost::uint32_t high_bits, boost::uint32_t begin, boost::uint32_t end, std::vector<TID>& result) const;
+	size_t getSizeinBytes() const;
+
+	/*! \brief container-aware intersection, runs are intersected as intervals and only the gaps between runs are cleared in bitsets*/
+	static RoaringContainer intersect(const RoaringContainer& left, const RoaringContainer& right);
+	/*! \brief container-aware union, runs are merged as intervals and set word by word in bitsets*/
+	static RoaringContainer unite(const RoaringContainer& left, const RoaringContainer& right);
+	/*! \brief container-aware difference (left AND NOT right), runs are subtracted as intervals and cleared word by word in bitsets*/
+	static RoaringContainer difference(const RoaringContainer& left, const RoaringContainer& right);
+
+private:
+	friend class boost::serialization::access;
+	template<class Archive>
+	void serialize(Archive& ar, const unsigned int){
+		ar & type_;
+		ar & cardinality_;
+		ar & values_;
+		ar & bits_;
+	}
+
+	/*! \brief returns a copy of a run container as array or bitset container, other containers are returned unchanged*/
+	RoaringContainer withoutRuns() const;
+	void toArray();
+	void toBitset();
+	/*! \brief chooses array or bitset representation according to the cardinality*/
+	void normalize();
+	boost::uint32_t countRuns() const;
+	/*! \brief appends the runs of an array or run container to runs as pairs of (start, length-1)*/
+	void getRuns(std::vector<boost::uint16_t>& runs) const;
+	/*! \brief appends the run [start, last] to runs, it is merged with the last run in case they overlap or touch*/
+	static void appendRun(std::vector<boost::uint16_t>& runs, boost::uint32_t start, boost::uint32_t last);
+	/*! \brief returns a run optimized container of runs, which have to be sorted and must neither overlap nor touch*/
+	static RoaringContainer fromRuns(std::vector<boost::uint16_t>& runs);
+	/*! \brief returns the values of array, which are covered (keep_covered) or not covered by the runs of run*/
+	static RoaringContainer filterArray(const RoaringContainer& array, const RoaringContainer& run, bool keep_covered);
+
+	ContainerType type_;
+	boost::uint32_t cardinality_;
+	/*! \brief array container: sorted values, run container: pairs of (start, length-1)*/
+	std::vector<boost::uint16_t> values_;
+	/*! \brief bitset container: one bit for each of the CHUNK_SIZE values*/
+	Bitmap bits_;
+};
+
+/*!
+ *  \brief     A RoaringBitmap is a compressed set of 32 bit positions (e.g., TIDs).
+ *  \details   The position space is split into chunks of 65536 positions, each non-empty chunk is stored in its own RoaringContainer.
+ *             Appending positions in ascending order is the fast path: when a new chunk is started, the previous one is complete and
+ *             gets run optimized. Boolean operations are evaluated container by container, so only chunks present on both sides
+ *             (AND) or on one side (OR, ANDNOT) are touched.
+ */
+class RoaringBitmap{
+public:
+	/***************** constructors and destructor *****************/
+	RoaringBitmap();
+
+	/***************** methods *****************/
+	/*! \brief adds position pos to the set*/
+	void add(boost::uint32_t pos);
+	/*! \brief removes position pos from the set*/
+	void remove(boost::uint32_t pos);
+	/*! \brief returns true in case position pos is in the set*/
+	bool contains(boost::uint32_t pos) const;
+	/*! \brief removes position pos from the set and moves all greater positions one position to the front
+	 *  \details this corresponds to deleting row pos from the column the bitmap belongs to*/
+	void erasePosition(boost::uint32_t pos);
+	void clear();
+	/*! \brief returns the number of positions in the set*/
+	size_t cardinality() const;
+	bool isEmpty() const;
+	/*! \brief converts every container into its smallest representation*/
+	void runOptimize();
+	/*! \brief appends all positions of the set to result in ascending order*/
+	void getPositions(std::vector<TID>& result) const;
+	/*! \brief appends all positions of the set in [begin, end) to result in ascending order, only the overlapping containers are visited*/
+	void getPositions(TID begin, TID end, std::vector<TID>& result) const;
+	/*! \brief returns the size in bytes the bitmap consumes in main memory*/
+	size_t getSizeinBytes() const;
+
+	RoaringBitmap operator&(const RoaringBitmap& bitmap) const;
+	RoaringBitmap operator|(const RoaringBitmap& bitmap) const;
+	RoaringBitmap andNot(const RoaringBitmap& bitmap) const;
+	RoaringBitmap& operator|=(const RoaringBitmap& bitmap);
+
+private:
+	friend class boost::serialization::access;
+	template<class Archive>
+	void serialize(Archive& ar, const unsigned int){
+		ar & keys_;
+		ar & containers_;
+	}
+
+	/*! \brief returns the index of the container with key, or the index where it would have to be inserted*/
+	size_t findContainer(boost::uint16_t key) const;
+
+	/*! \brief upper 16 bits of the positions in each container, sorted ascending*/
+	std::vector<boost::uint16_t> keys_;
+	std::vector<RoaringContainer> containers_;
+};
+
+
+/***************** Start of Implementation Section ******************/
+
+	inline RoaringContainer::RoaringContainer() : type_(ARRAY_CONTAINER), cardinality_(0), values_(), bits_(){
+
+	}
+
+	inline void RoaringContainer::add(boost::uint16_t value){
+		if(type_==RUN_CONTAINER){
+			if(contains(value)) return;
+			*this = withoutRuns();
+		}
+		if(type_==ARRAY_CONTAINER){
+			//values are usually appended in ascending order, so check the end first
+			if(values_.empty() || values_.back()<value){
+				values_.push_back(value);
+			}else{
+				std::vector<boost::uint16_t>::iterator it = std::lower_bound(values_.begin(),values_.end(),value);
+				if(*it==value) return;
+				values_.insert(it,value);
+			}
+			cardinality_++;
+			if(cardinality_>MAX_ARRAY_CARDINALITY) toBitset();
+		}else{
+			if(bits_.test(value)) return;
+			bits_.set(value);
+			cardinality_++;
+		}
+	}
+
+	inline void RoaringContainer::remove(boost::uint16_t value){
+		if(!contains(value)) return;
+		if(type_==RUN_CONTAINER){
+			*this = withoutRuns();
+		}
+		if(type_==ARRAY_CONTAINER){
+			values_.erase(std::lower_bound(values_.begin(),values_.end(),value));
+			cardinality_--;
+		}else{
+			bits_.reset(value);
+			cardinality_--;
+			normalize();
+		}
+	}
+
+	inline bool RoaringContainer::contains(boost::uint16_t value) const{
+		if(type_==ARRAY_CONTAINER){
+			return std::binary_search(values_.begin(),values_.end(),value);
+		}else if(type_==BITSET_CONTAINER){
+			return bits_.test(value);
+		}
+		//find the last run starting at or before value
+		size_t lower = 0, upper = values_.size()/2;
+		while(lower<upper){
+			size_t middle = (lower+upper)/2;
+			if(values_[2*middle]<=value){
+				lower = middle+1;
+			}else{
+				upper = middle;
+			}
+		}
+		if(lower==0) return false;
+		boost::uint32_t start = values_[2*(lower-1)];
+		return boost::uint32_t(value) <= start + values_[2*(lower-1)+1];
+	}
+
+	inline boost::uint32_t RoaringContainer::cardinality() const{
+		return cardinality_;
+	}
+
+	inline void RoaringContainer::appendPositions(boost::uint32_t high_bits, std::vector<TID>& result) const{
+		if(type_==ARRAY_CONTAINER){
+			for(size_t i = 0; i < values_.size(); i++){
+				result.push_back(high_bits | values_[i]);
+			}
+		}else if(type_==BITSET_CONTAINER){
+			const std::vector<boost::uint64_t>& words = bits_.getWords();
+			for(size_t i = 0; i < words.size(); i++){
+				boost::uint64_t word = words[i];
+				while(word){
+					result.push_back(high_bits | (i*64 + __builtin_ctzll(word)));
+					//clear lowest set bit
+					word &= word - 1;
+				}
+			}
+		}else{
+			for(size_t i = 0; i < values_.size(); i += 2){
+				boost::uint32_t end = boost::uint32_t(values_[i]) + values_[i+1];
+				for(boost::uint32_t value = values_[i]; value <= end; value++){
+					result.push_back(high_bits | value);
+				}
+			}
+		}
+	}
+
+	inline void RoaringContainer::appendPositions(boost::uint32_t high_bits, boost::uint32_t begin, boost::uint32_t end, std::vector<TID>& result) const{
+		if(begin>=end) return;
+		if(type_==ARRAY_CONTAINER){
+			for(size_t i = std::lower_bound(values_.begin(),values_.end(),boost::uint16_t(begin)) - values_.begin(); i < values_.size() && values_[i] < end; i++){
+				result.push_back(high_bits | values_[i]);
+			}
+		}else if(type_==BITSET_CONTAINER){
+			const std::vector<boost::uint64_t>& words = bits_.getWords();
+			for(size_t i = begin/64; i < words.size() && i*64 < end; i++){
+				boost::uint64_t word = words[i];
+				//mask the bits in front of begin and behind end
+				if(i == begin/64) word &= ~boost::uint64_t(0) << (begin%64);
+				if(i == (end-1)/64 && end%64) word &= ~(~boost::uint64_t(0) << (end%64));
+				while(word){
+					result.push_back(high_bits | (i*64 + __builtin_ctzll(word)));
+					word &= word - 1;
+				}
+			}
+		}else{
+			for(size_t i = 0; i < values_.size() && values_[i] < end; i += 2){
+				boost::uint32_t last = std::min(boost::uint32_t(values_[i]) + values_[i+1], end-1);
+				for(boost::uint32_t value = std::max(boost::uint32_t(values_[i]), begin); value <= last; value++){
+					result.push_back(high_bits | value);
+				}
+			}
+		}
+	}
+
+	inline size_t RoaringContainer::getSizeinBytes() const{
+		size_t size = sizeof(RoaringContainer) + values_.capacity()*sizeof(boost::uint16_t);
+		if(type_==BITSET_CONTAINER){
+			size += bits_.getSizeinBytes() - sizeof(Bitmap);
+		}
+		return size;
+	}
+
+	inline boost::uint32_t RoaringContainer::countRuns() const{
+		if(type_==RUN_CONTAINER) return values_.size()/2;
+		boost::uint32_t runs = 0;
+		if(type_==ARRAY_CONTAINER){
+			for(size_t i = 0; i < values_.size(); i++){
+				if(i==0 || values_[i]!=values_[i-1]+1) runs++;
+			}
+		}else{
+			//a run starts at every set bit whose predecessor is not set
+			const std::vector<boost::uint64_t>& words = bits_.getWords();
+			boost::uint64_t carry = 0;
+			for(size_t i = 0; i < words.size(); i++){
+				runs += __builtin_popcountll(words[i] & ~((words[i] << 1) | carry));
+				carry = words[i] >> 63;
+			}
+		}
+		return runs;
+	}
+
+	inline void RoaringContainer::runOptimize(){
+		boost::uint32_t runs = countRuns();
+		size_t run_size = runs*2*sizeof(boost::uint16_t);
+		size_t array_size = cardinality_*sizeof(boost::uint16_t);
+		size_t bitset_size = CHUNK_SIZE/8;
+		if(run_size < std::min(array_size,bitset_size)){
+			if(type_==RUN_CONTAINER) return;
+			std::vector<TID> positions;
+			positions.reserve(cardinality_);
+			appendPositions(0,positions);
+			std::vector<boost::uint16_t> run_values;
+			run_values.reserve(runs*2);
+			for(size_t i = 0; i < positions.size(); i++){
+				if(i==0 || positions[i]!=positions[i-1]+1){
+					run_values.push_back(positions[i]);
+					run_values.push_back(0);
+				}else{
+					run_values.back()++;
+				}
+			}
+			values_.swap(run_values);
+			bits_.clear();
+			type_ = RUN_CONTAINER;
+		}else{
+			if(type_==RUN_CONTAINER) *this = withoutRuns();
+			normalize();
+		}
+	}
+
+	inline RoaringContainer RoaringContainer::withoutRuns() const{
+		if(type_!=RUN_CONTAINER) return *this;
+		RoaringContainer container;
+		container.cardinality_ = cardinality_;
+		if(cardinality_>MAX_ARRAY_CARDINALITY){
+			container.type_ = BITSET_CONTAINER;
+			container.bits_ = Bitmap(CHUNK_SIZE);
+			for(size_t i = 0; i < values_.size(); i += 2){
+				container.bits_.setRange(values_[i], boost::uint32_t(values_[i]) + values_[i+1] + 1);
+			}
+		}else{
+			container.values_.reserve(cardinality_);
+			for(size_t i = 0; i < values_.size(); i += 2){
+				boost::uint32_t end = boost::uint32_t(values_[i]) + values_[i+1];
+				for(boost::uint32_t value = values_[i]; value <= end; value++){
+					container.values_.push_back(value);
+				}
+			}
+		}
+		return container;
+	}
+
+	inline void RoaringContainer::toArray(){
+		if(type_==ARRAY_CONTAINER) return;
+		std::vector<TID> positions;
+		positions.reserve(cardinality_);
+		appendPositions(0,positions);
+		values_.assign(positions.begin(),positions.end());
+		bits_.clear();
+		type_ = ARRAY_CONTAINER;
+	}
+
+	inline void RoaringContainer::toBitset(){
+		if(type_==BITSET_CONTAINER) return;
+		Bitmap bits(CHUNK_SIZE);
+		std::vector<TID> positions;
+		positions.reserve(cardinality_);
+		appendPositions(0,positions);
+		for(size_t i = 0; i < positions.size(); i++){
+			bits.set(positions[i]);
+		}
+		bits_ = bits;
+		values_.clear();
+		type_ = BITSET_CONTAINER;
+	}
+
+	inline void RoaringContainer::normalize(){
+		if(type_==BITSET_CONTAINER && cardinality_<=MAX_ARRAY_CARDINALITY){
+			toArray();
+		}else if(type_==ARRAY_CONTAINER && cardinality_>MAX_ARRAY_CARDINALITY){
+			toBitset();
+		}
+	}
+
+	inline void RoaringContainer::getRuns(std::vector<boost::uint16_t>& runs) const{
+		if(type_==RUN_CONTAINER){
+			runs.insert(runs.end(),values_.begin(),values_.end());
+			return;
+		}
+		for(size_t i = 0; i < values_.size(); i++){
+			appendRun(runs,values_[i],values_[i]);
+		}
+	}
+
+	inline void RoaringContainer::appendRun(std::vector<boost::uint16_t>& runs, boost::uint32_t start, boost::uint32_t last){
+		if(!runs.empty()){
+			boost::uint32_t previous_start = runs[runs.size()-2];
+			boost::uint32_t previous_last = previous_start + runs.back();
+			if(start <= previous_last+1){
+				if(last > previous_last) runs.back() = last - previous_start;
+				return;
+			}
+		}
+		runs.push_back(start);
+		runs.push_back(last - start);
+	}
+
+	inline RoaringContainer RoaringContainer::fromRuns(std::vector<boost::uint16_t>& runs){
+		RoaringContainer result;
+		if(runs.empty()) return result;
+		result.type_ = RUN_CONTAINER;
+		result.values_.swap(runs);
+		for(size_t i = 0; i < result.values_.size(); i += 2){
+			result.cardinality_ += boost::uint32_t(result.values_[i+1]) + 1;
+		}
+		result.runOptimize();
+		return result;
+	}
+
+	inline RoaringContainer RoaringContainer::filterArray(const RoaringContainer& array, const RoaringContainer& run, bool keep_covered){
+		RoaringContainer result;
+		size_t j = 0;
+		for(size_t i = 0; i < array.values_.size(); i++){
+			boost::uint16_t value = array.values_[i];
+			//skip the runs ending in front of value, both lists are sorted
+			while(j < run.values_.size() && boost::uint32_t(run.values_[j]) + run.values_[j+1] < value) j += 2;
+			bool covered = j < run.values_.size() && run.values_[j] <= value;
+			if(covered==keep_covered) result.values_.push_back(value);
+		}
+		result.cardinality_ = result.values_.size();
+		return result;
+	}
+
+	inline RoaringContainer RoaringContainer::intersect(const RoaringContainer& left, const RoaringContainer& right){
+		RoaringContainer result;
+		if(left.type_==RUN_CONTAINER || right.type_==RUN_CONTAINER){
+			const RoaringContainer& run = (left.type_==RUN_CONTAINER) ? left : right;
+			const RoaringContainer& other = (left.type_==RUN_CONTAINER) ? right : left;
+			if(other.type_==ARRAY_CONTAINER){
+				return filterArray(other,run,true);
+			}else if(other.type_==BITSET_CONTAINER){
+				//clear the gaps in front of, between and behind the runs
+				result = other;
+				boost::uint32_t gap_begin = 0;
+				for(size_t i = 0; i < run.values_.size(); i += 2){
+					result.bits_.resetRange(gap_begin,run.values_[i]);
+					gap_begin = boost::uint32_t(run.values_[i]) + run.values_[i+1] + 1;
+				}
+				result.bits_.resetRange(gap_begin,CHUNK_SIZE);
+				result.cardinality_ = result.bits_.count();
+				result.normalize();
+				return result;
+			}
+			std::vector<boost::uint16_t> runs;
+			size_t i = 0, j = 0;
+			while(i < left.values_.size() && j < right.values_.size()){
+				boost::uint32_t left_last = boost::uint32_t(left.values_[i]) + left.values_[i+1];
+				boost::uint32_t right_last = boost::uint32_t(right.values_[j]) + right.values_[j+1];
+				boost::uint32_t start = std::max(left.values_[i],right.values_[j]);
+				boost::uint32_t last = std::min(left_last,right_last);
+				if(start <= last) appendRun(runs,start,last);
+				if(left_last < right_last){
+					i += 2;
+				}else{
+					j += 2;
+				}
+			}
+			return fromRuns(runs);
+		}
+		if(left.type_==ARRAY_CONTAINER && right.type_==ARRAY_CONTAINER){
+			std::set_intersection(left.values_.begin(),left.values_.end(),right.values_.begin(),right.values_.end(),std::back_inserter(result.values_));
+			result.cardinality_ = result.values_.size();
+		}else if(left.type_==ARRAY_CONTAINER || right.type_==ARRAY_CONTAINER){
+			const RoaringContainer& array = (left.type_==ARRAY_CONTAINER) ? left : right;
+			const RoaringContainer& bitset = (left.type_==ARRAY_CONTAINER) ? right : left;
+			for(size_t i = 0; i < array.values_.size(); i++){
+				if(bitset.bits_.test(array.values_[i])) result.values_.push_back(array.values_[i]);
+			}
+			result.cardinality_ = result.values_.size();
+		}else{
+			result.type_ = BITSET_CONTAINER;
+			result.bits_ = left.bits_;
+			result.bits_ &= right.bits_;
+			result.cardinality_ = result.bits_.count();
+			result.normalize();
+		}
+		return result;
+	}
+
+	inline RoaringContainer RoaringContainer::unite(const RoaringContainer& left, const RoaringContainer& right){
+		RoaringContainer result;
+		if(left.type_==RUN_CONTAINER || right.type_==RUN_CONTAINER){
+			const RoaringContainer& run = (left.type_==RUN_CONTAINER) ? left : right;
+			const RoaringContainer& other = (left.type_==RUN_CONTAINER) ? right : left;
+			if(other.type_==BITSET_CONTAINER){
+				result = other;
+				for(size_t i = 0; i < run.values_.size(); i += 2){
+					result.bits_.setRange(run.values_[i],boost::uint32_t(run.values_[i]) + run.values_[i+1] + 1);
+				}
+				result.cardinality_ = result.bits_.count();
+				return result;
+			}
+			//merge both run lists by their starts, an array contributes a run per maximal sequence of consecutive values
+			std::vector<boost::uint16_t> other_runs;
+			other.getRuns(other_runs);
+			std::vector<boost::uint16_t> runs;
+			size_t i = 0, j = 0;
+			while(i < run.values_.size() || j < other_runs.size()){
+				if(j==other_runs.size() || (i < run.values_.size() && run.values_[i] < other_runs[j])){
+					appendRun(runs,run.values_[i],boost::uint32_t(run.values_[i]) + run.values_[i+1]);
+					i += 2;
+				}else{
+					appendRun(runs,other_runs[j],boost::uint32_t(other_runs[j]) + other_runs[j+1]);
+					j += 2;
+				}
+			}
+			return fromRuns(runs);
+		}
+		if(left.type_==ARRAY_CONTAINER && right.type_==ARRAY_CONTAINER){
+			std::set_union(left.values_.begin(),left.values_.end(),right.values_.begin(),right.values_.end(),std::back_inserter(result.values_));
+			result.cardinality_ = result.values_.size();
+			result.normalize();
+		}else if(left.type_==ARRAY_CONTAINER || right.type_==ARRAY_CONTAINER){
+			const RoaringContainer& array = (left.type_==ARRAY_CONTAINER) ? left : right;
+			result = (left.type_==ARRAY_CONTAINER) ? right : left;
+			for(size_t i = 0; i < array.values_.size(); i++){
+				result.add(array.values_[i]);
+			}
+		}else{
+			result.type_ = BITSET_CONTAINER;
+			result.bits_ = left.bits_;
+			result.bits_ |= right.bits_;
+			result.cardinality_ = result.bits_.count();
+		}
+		return result;
+	}
+
+	inline RoaringContainer RoaringContainer::difference(const RoaringContainer& left, const RoaringContainer& right){
+		RoaringContainer result;
+		if(left.type_==RUN_CONTAINER){
+			if(right.type_==BITSET_CONTAINER){
+				result.type_ = BITSET_CONTAINER;
+				result.bits_ = Bitmap(CHUNK_SIZE);
+				for(size_t i = 0; i < left.values_.size(); i += 2){
+					result.bits_.setRange(left.values_[i],boost::uint32_t(left.values_[i]) + left.values_[i+1] + 1);
+				}
+				result.bits_.andNot(right.bits_);
+				result.cardinality_ = result.bits_.count();
+				result.normalize();
+				return result;
+			}
+			//subtract the runs of right from the runs of left, a run of right may overlap several runs of left
+			std::vector<boost::uint16_t> right_runs;
+			right.getRuns(right_runs);
+			std::vector<boost::uint16_t> runs;
+			size_t j = 0;
+			for(size_t i = 0; i < left.values_.size(); i += 2){
+				boost::uint32_t next = left.values_[i];
+				boost::uint32_t last = next + left.values_[i+1];
+				while(j < right_runs.size() && boost::uint32_t(right_runs[j]) + right_runs[j+1] < next) j += 2;
+				for(size_t k = j; k < right_runs.size() && right_runs[k] <= last && next <= last; k += 2){
+					if(right_runs[k] > next) appendRun(runs,next,right_runs[k]-1);
+					next = boost::uint32_t(right_runs[k]) + right_runs[k+1] + 1;
+				}
+				if(next <= last) appendRun(runs,next,last);
+			}
+			return fromRuns(runs);
+		}
+		if(right.type_==RUN_CONTAINER){
+			if(left.type_==ARRAY_CONTAINER){
+				return filterArray(left,right,false);
+			}
+			result = left;
+			for(size_t i = 0; i < right.values_.size(); i += 2){
+				result.bits_.resetRange(right.values_[i],boost::uint32_t(right.values_[i]) + right.values_[i+1] + 1);
+			}
+			result.cardinality_ = result.bits_.count();
+			result.normalize();
+			return result;
+		}
+		if(left.type_==ARRAY_CONTAINER){
+			if(right.type_==ARRAY_CONTAINER){
+				std::set_difference(left.values_.begin(),left.values_.end(),right.values_.begin(),right.values_.end(),std::back_inserter(result.values_));
+			}else{
+				for(size_t i = 0; i < left.values_.size(); i++){
+					if(!right.bits_.test(left.values_[i])) result.values_.push_back(left.values_[i]);
+				}
+			}
+			result.cardinality_ = result.values_.size();
+		}else{
+			result = left;
+			if(right.type_==ARRAY_CONTAINER){
+				for(size_t i = 0; i < right.values_.size(); i++){
+					result.bits_.reset(right.values_[i]);
+				}
+			}else{
+				result.bits_.andNot(right.bits_);
+			}
+			result.cardinality_ = result.bits_.count();
+			result.normalize();
+		}
+		return result;
+	}
+
+	inline RoaringBitmap::RoaringBitmap() : keys_(), containers_(){
+
+	}
+
+	inline size_t RoaringBitmap::findContainer(boost::uint16_t key) const{
+		return std::lower_bound(keys_.begin(),keys_.end(),key) - keys_.begin();
+	}
+
+	inline void RoaringBitmap::add(boost::uint32_t pos){
+		boost::uint16_t key = pos >> 16;
+		if(keys_.empty() || keys_.back()<key){
+			//the previous chunk will not receive appends anymore
+			if(!containers_.empty()) containers_.back().runOptimize();
+			keys_.push_back(key);
+			containers_.push_back(RoaringContainer());
+			containers_.back().add(pos & 0xFFFF);
+			return;
+		}
+		size_t index = findContainer(key);
+		if(keys_[index]!=key){
+			keys_.insert(keys_.begin()+index,key);
+			containers_.insert(containers_.begin()+index,RoaringContainer());
+		}
+		containers_[index].add(pos & 0xFFFF);
+	}
+
+	inline void RoaringBitmap::remove(boost::uint32_t pos){
+		boost::uint16_t key = pos >> 16;
+		size_t index = findContainer(key);
+		if(index==keys_.size() || keys_[index]!=key) return;
+		containers_[index].remove(pos & 0xFFFF);
+		if(containers_[index].cardinality()==0){
+			keys_.erase(keys_.begin()+index);
+			containers_.erase(containers_.begin()+index);
+		}
+	}
+
+	inline bool RoaringBitmap::contains(boost::uint32_t pos) const{
+		boost::uint16_t key = pos >> 16;
+		size_t index = findContainer(key);
+		if(index==keys_.size() || keys_[index]!=key) return false;
+		return containers_[index].contains(pos & 0xFFFF);
+	}
+
+	inline void RoaringBitmap::erasePosition(boost::uint32_t pos){
+		size_t index = findContainer(pos >> 16);
+		if(index==keys_.size()) return;
+		//only the chunks starting at the chunk of pos are affected, rebuild them from their shifted positions
+		std::vector<TID> positions;
+		for(size_t i = index; i < containers_.size(); i++){
+			containers_[i].appendPositions(boost::uint32_t(keys_[i]) << 16,positions);
+		}
+		keys_.resize(index);
+		containers_.resize(index);
+		for(size_t i = 0; i < positions.size(); i++){
+			if(positions[i]<pos){
+				add(positions[i]);
+			}else if(positions[i]>pos){
+				add(positions[i]-1);
+			}
+		}
+	}
+
+	inline void RoaringBitmap::clear(){
+		keys_.clear();
+		containers_.clear();
+	}
+
+	inline size_t RoaringBitmap::cardinality() const{
+		size_t result = 0;
+		for(size_t i = 0; i < containers_.size(); i++){
+			result += containers_[i].cardinality();
+		}
+		return result;
+	}
+
+	inline bool RoaringBitmap::isEmpty() const{
+		return containers_.empty();
+	}
+
+	inline void RoaringBitmap::runOptimize(){
+		for(size_t i = 0; i < containers_.size(); i++){
+			containers_[i].runOptimize();
+		}
+	}
+
+	inline void RoaringBitmap::getPositions(std::vector<TID>& result) const{
+		result.reserve(result.size()+cardinality());
+		for(size_t i = 0; i < containers_.size(); i++){
+			containers_[i].appendPositions(boost::uint32_t(keys_[i]) << 16,result);
+		}
+	}
+
+	inline void RoaringBitmap::getPositions(TID begin, TID end, std::vector<TID>& result) const{
+		if(begin>=end) return;
+		for(size_t i = findContainer(begin >> 16); i < containers_.size() && keys_[i] <= ((end-1) >> 16); i++){
+			boost::uint32_t high_bits = boost::uint32_t(keys_[i]) << 16;
+			boost::uint32_t container_begin = (begin > high_bits) ? begin - high_bits : 0;
+			boost::uint32_t container_end = std::min<TID>(end - high_bits, TID(RoaringContainer::CHUNK_SIZE));
+			containers_[i].appendPositions(high_bits, container_begin, container_end, result);
+		}
+	}
+
+	inline size_t RoaringBitmap::getSizeinBytes() const{
+		size_t size = sizeof(RoaringBitmap) + keys_.capacity()*sizeof(boost::uint16_t);
+		for(size_t i = 0; i < containers_.size(); i++){
+			size += containers_[i].getSizeinBytes();
+		}
+		return size;
+	}
+
+	inline RoaringBitmap RoaringBitmap::operator&(const RoaringBitmap& bitmap) const{
+		RoaringBitmap result;
+		size_t i = 0, j = 0;
+		while(i<keys_.size() && j<bitmap.keys_.size()){
+			if(keys_[i]<bitmap.keys_[j]){
+				i++;
+			}else if(keys_[i]>bitmap.keys_[j]){
+				j++;
+			}else{
+				RoaringContainer container = RoaringContainer::intersect(containers_[i],bitmap.containers_[j]);
+				if(container.cardinality()>0){
+					result.keys_.push_back(keys_[i]);
+					result.containers_.push_back(container);
+				}
+				i++; j++;
+			}
+		}
+		return result;
+	}
+
+	inline RoaringBitmap RoaringBitmap::operator|(const RoaringBitmap& bitmap) const{
+		RoaringBitmap result;
+		size_t i = 0, j = 0;
+		while(i<keys_.size() || j<bitmap.keys_.size()){
+			if(j==bitmap.keys_.size() || (i<keys_.size() && keys_[i]<bitmap.keys_[j])){
+				result.keys_.push_back(keys_[i]);
+				result.containers_.push_back(containers_[i]);
+				i++;
+			}else if(i==keys_.size() || keys_[i]>bitmap.keys_[j]){
+				result.keys_.push_back(bitmap.keys_[j]);
+				result.containers_.push_back(bitmap.containers_[j]);
+				j++;
+			}else{
+				result.keys_.push_back(keys_[i]);
+				result.containers_.push_back(RoaringContainer::unite(containers_[i],bitmap.containers_[j]));
+				i++; j++;
+			}
+		}
+		return result;
+	}
+
+	inline RoaringBitmap RoaringBitmap::andNot(const RoaringBitmap& bitmap) const{
+		RoaringBitmap result;
+		size_t j = 0;
+		for(size_t i = 0; i < keys_.size(); i++){
+			while(j<bitmap.keys_.size() && bitmap.keys_[j]<keys_[i]) j++;
+			if(j<bitmap.keys_.size() && bitmap.keys_[j]==keys_[i]){
+				RoaringContainer container = RoaringContainer::difference(containers_[i],bitmap.containers_[j]);
+				if(container.cardinality()>0){
+					result.keys_.push_back(keys_[i]);
+					result.containers_.push_back(container);
+				}
+			}else{
+				result.keys_.push_back(keys_[i]);
+				result.containers_.push_back(containers_[i]);
+			}
+		}
+		return result;
+	}
+
+	inline RoaringBitmap& RoaringBitmap::operator|=(const RoaringBitmap& bitmap){
+		*this = *this | bitmap;
+		return *this;
+	}
+
+/***************** End of Implementation Section ******************/
+
+}; //end namespace CogaDB
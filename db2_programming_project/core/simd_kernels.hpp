@@ -0,0 +1,474 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <boost/cstdint.hpp>
+#include <core/global_definitions.hpp>
+
+#if defined(__x86_64__) && defined(__GNUC__)
+	/*! \brief SIMD kernels are compiled with function level target attributes and selected at runtime, so no compiler flags are required*/
+	#define COGADB_ENABLE_SIMD_KERNELS
+	#include <immintrin.h>
+#endif
+
+namespace CoGaDB{
+
+/*!
+ *  \file simd_kernels.hpp
+ *  \brief Vectorized kernels for scans over bit packed and plain arrays and for arithmetic on plain arrays.
+ *  \details Every kernel has a scalar implementation, which is used on other architectures and for the remaining elements
+ *           that do not fill a whole SIMD register. The AVX2 variants are chosen at runtime in case the processor supports them,
+ *           the SSE2 variants are always available on x86-64.
+ */
+
+/*! \brief returns true in case the processor supports AVX2*/
+inline bool cpu_supports_avx2(){
+#ifdef COGADB_ENABLE_SIMD_KERNELS
+	static const bool supported = __builtin_cpu_supports("avx2");
+	return supported;
+#else
+	return false;
+#endif
+}
+
+/*! \brief reads value number index of a bit packed array of words, where every value has bits_per_value bits (at most 64)*/
+inline boost::uint64_t read_packed_value(const boost::uint64_t* words, size_t index, unsigned int bits_per_value){
+	if(bits_per_value==0) return 0;
+	boost::uint64_t first_bit = boost::uint64_t(index)*bits_per_value;
+	size_t word = first_bit/64;
+	unsigned int shift = first_bit%64;
+	boost::uint64_t value = words[word] >> shift;
+	if(shift+bits_per_value>64){
+		value |= words[word+1] << (64-shift);
+	}
+	if(bits_per_value<64){
+		value &= (boost::uint64_t(1) << bits_per_value) - 1;
+	}
+	return value;
+}
+
+/*! \brief unpacks count values starting at value number begin into out (scalar implementation, bits_per_value<=32)*/
+inline void unpack_bits_scalar(const boost::uint64_t* words, size_t begin, size_t count, unsigned int bits_per_value, boost::uint32_t* out){
+	for(size_t i = 0; i < count; i++){
+		out[i] = read_packed_value(words, begin+i, bits_per_value);
+	}
+}
+
+#ifdef COGADB_ENABLE_SIMD_KERNELS
+/*! \brief unpacks count values starting at value number begin into out (AVX2 implementation, bits_per_value<=25)
+ *  \details Every lane gathers the 32 bit word starting at the byte of its value and shifts the value down. A value of at most
+ *           25 bits starting at bit 0..7 of a byte always lies within these 32 bits. The gather may read up to three bytes behind
+ *           the last value, so the packed array needs one padding word.*/
+__attribute__((target("avx2")))
+inline void unpack_bits_avx2(const boost::uint64_t* words, size_t begin, size_t count, unsigned int bits_per_value, boost::uint32_t* out){
+	const char* bytes = reinterpret_cast<const char*>(words);
+	const __m256i lane_bit_offsets = _mm256_mullo_epi32(_mm256_setr_epi32(0,1,2,3,4,5,6,7), _mm256_set1_epi32(bits_per_value));
+	const __m256i mask = _mm256_set1_epi32((boost::uint32_t(1) << bits_per_value) - 1);
+	const __m256i seven = _mm256_set1_epi32(7);
+	size_t i = 0;
+	for(; i+8 <= count; i += 8){
+		boost::uint64_t first_bit = boost::uint64_t(begin+i)*bits_per_value;
+		const char* base = bytes + first_bit/8;
+		__m256i bit_offsets = _mm256_add_epi32(lane_bit_offsets, _mm256_set1_epi32(first_bit%8));
+		__m256i gathered = _mm256_i32gather_epi32(reinterpret_cast<const int*>(base), _mm256_srli_epi32(bit_offsets, 3), 1);
+		__m256i values = _mm256_and_si256(_mm256_srlv_epi32(gathered, _mm256_and_si256(bit_offsets, seven)), mask);
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(out+i), values);
+	}
+	unpack_bits_scalar(words, begin+i, count-i, bits_per_value, out+i);
+}
+#endif
+
+/*! \brief unpacks count values starting at value number begin into out (bits_per_value<=32), uses the fastest available kernel*/
+inline void unpack_bits(const boost::uint64_t* words, size_t begin, size_t count, unsigned int bits_per_value, boost::uint32_t* out){
+#ifdef COGADB_ENABLE_SIMD_KERNELS
+	if(bits_per_value>0 && bits_per_value<=25 && cpu_supports_avx2()){
+		unpack_bits_avx2(words, begin, count, bits_per_value, out);
+		return;
+	}
+#endif
+	unpack_bits_scalar(words, begin, count, bits_per_value, out);
+}
+
+/*! \brief appends first_tid+i to result for every values[i] in [lower, upper) (scalar implementation)*/
+inline void find_in_range_scalar(const boost::uint32_t* values, size_t count, boost::uint32_t lower, boost::uint32_t upper, TID first_tid, std::vector<TID>& result){
+	//one unsigned comparison checks both bounds
+	boost::uint32_t range = upper - lower;
+	for(size_t i = 0; i < count; i++){
+		if(values[i] - lower < range){
+			result.push_back(first_tid+i);
+		}
+	}
+}
+
+#ifdef COGADB_ENABLE_SIMD_KERNELS
+/*! \brief appends the positions of all set bits in mask to result*/
+inline void append_mask_positions(unsigned int mask, TID first_tid, std::vector<TID>& result){
+	while(mask){
+		result.push_back(first_tid + __builtin_ctz(mask));
+		mask &= mask - 1;
+	}
+}
+
+/*! \brief appends first_tid+i to result for every values[i] in [lower, upper) (SSE2 implementation)*/
+inline void find_in_range_sse2(const boost::uint32_t* values, size_t count, boost::uint32_t lower, boost::uint32_t upper, TID first_tid, std::vector<TID>& result){
+	//SSE2 only compares signed integers, flipping the sign bit maps the unsigned order to the signed order
+	const __m128i sign = _mm_set1_epi32(0x80000000);
+	const __m128i lower_vec = _mm_set1_epi32(lower);
+	const __m128i range = _mm_xor_si128(_mm_set1_epi32(upper - lower), sign);
+	size_t i = 0;
+	for(; i+4 <= count; i += 4){
+		__m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(values+i));
+		__m128i shifted = _mm_xor_si128(_mm_sub_epi32(v, lower_vec), sign);
+		unsigned int mask = _mm_movemask_ps(_mm_castsi128_ps(_mm_cmplt_epi32(shifted, range)));
+		append_mask_positions(mask, first_tid+i, result);
+	}
+	find_in_range_scalar(values+i, count-i, lower, upper, first_tid+i, result);
+}
+
+/*! \brief appends first_tid+i to result for every values[i] in [lower, upper) (AVX2 implementation)*/
+__attribute__((target("avx2")))
+inline void find_in_range_avx2(const boost::uint32_t* values, size_t count, boost::uint32_t lower, boost::uint32_t upper, TID first_tid, std::vector<TID>& result){
+	const __m256i sign = _mm256_set1_epi32(0x80000000);
+	const __m256i lower_vec = _mm256_set1_epi32(lower);
+	const __m256i range = _mm256_xor_si256(_mm256_set1_epi32(upper - lower), sign);
+	size_t i = 0;
+	for(; i+8 <= count; i += 8){
+		__m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(values+i));
+		__m256i shifted = _mm256_xor_si256(_mm256_sub_epi32(v, lower_vec), sign);
+		unsigned int mask = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(range, shifted)));
+		append_mask_positions(mask, first_tid+i, result);
+	}
+	find_in_range_scalar(values+i, count-i, lower, upper, first_tid+i, result);
+}
+#endif
+
+/*! \brief appends first_tid+i to result for every values[i] in [lower, upper), uses the fastest available kernel*/
+inline void find_in_range(const boost::uint32_t* values, size_t count, boost::uint32_t lower, boost::uint32_t upper, TID first_tid, std::vector<TID>& result){
+#ifdef COGADB_ENABLE_SIMD_KERNELS
+	if(cpu_supports_avx2()){
+		find_in_range_avx2(values, count, lower, upper, first_tid, result);
+	}else{
+		find_in_range_sse2(values, count, lower, upper, first_tid, result);
+	}
+#else
+	find_in_range_scalar(values, count, lower, upper, first_tid, result);
+#endif
+}
+
+/*! \brief compares a with b according to comparator comp*/
+template<int comp, class T>
+inline bool compare_values(const T& a, const T& b){
+	if(comp==EQUAL) return a==b;
+	if(comp==LESSER) return a<b;
+	return a>b;
+}
+
+/*! \brief writes first_tid+i to out for every values[i] fulfilling the predicate, returns the number of written TIDs (scalar implementation)
+ *  \details The TID is written unconditionally and the output position only advances on a match, so the loop has no branch on the data.*/
+template<int comp, class T>
+inline size_t select_values_scalar(const T* values, size_t count, const T& value, TID first_tid, TID* out){
+	size_t written = 0;
+	for(size_t i = 0; i < count; i++){
+		out[written] = first_tid+i;
+		written += compare_values<comp>(values[i], value);
+	}
+	return written;
+}
+
+#ifdef COGADB_ENABLE_SIMD_KERNELS
+/*! \brief writes the positions of all set bits in mask to out, returns the number of written TIDs*/
+inline size_t write_mask_positions(unsigned int mask, TID first_tid, TID* out){
+	size_t written = 0;
+	while(mask){
+		out[written++] = first_tid + __builtin_ctz(mask);
+		mask &= mask - 1;
+	}
+	return written;
+}
+
+/*! \brief returns one bit per lane of v fulfilling the predicate (SSE2 implementation)*/
+template<int comp>
+inline unsigned int compare_mask_sse2(__m128i v, __m128i value){
+	if(comp==EQUAL) return _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(v, value)));
+	if(comp==LESSER) return _mm_movemask_ps(_mm_castsi128_ps(_mm_cmplt_epi32(v, value)));
+	return _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpgt_epi32(v, value)));
+}
+
+template<int comp>
+inline unsigned int compare_mask_sse2(__m128 v, __m128 value){
+	if(comp==EQUAL) return _mm_movemask_ps(_mm_cmpeq_ps(v, value));
+	if(comp==LESSER) return _mm_movemask_ps(_mm_cmplt_ps(v, value));
+	return _mm_movemask_ps(_mm_cmpgt_ps(v, value));
+}
+
+/*! \brief returns one bit per lane of v fulfilling the predicate (AVX2 implementation)*/
+template<int comp>
+__attribute__((target("avx2")))
+inline unsigned int compare_mask_avx2(__m256i v, __m256i value){
+	if(comp==EQUAL) return _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(v, value)));
+	if(comp==LESSER) return _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(value, v)));
+	return _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(v, value)));
+}
+
+template<int comp>
+__attribute__((target("avx2")))
+inline unsigned int compare_mask_avx2(__m256 v, __m256 value){
+	//ordered comparisons, a NaN never fulfills a predicate like in the scalar implementation
+	if(comp==EQUAL) return _mm256_movemask_ps(_mm256_cmp_ps(v, value, _CMP_EQ_OQ));
+	if(comp==LESSER) return _mm256_movemask_ps(_mm256_cmp_ps(v, value, _CMP_LT_OQ));
+	return _mm256_movemask_ps(_mm256_cmp_ps(v, value, _CMP_GT_OQ));
+}
+
+/*! \brief writes first_tid+i to out for every values[i] fulfilling the predicate, returns the number of written TIDs (SSE2 implementation)*/
+template<int comp>
+inline size_t select_values_sse2(const boost::int32_t* values, size_t count, boost::int32_t value, TID first_tid, TID* out){
+	const __m128i value_vec = _mm_set1_epi32(value);
+	size_t written = 0;
+	size_t i = 0;
+	for(; i+4 <= count; i += 4){
+		__m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(values+i));
+		written += write_mask_positions(compare_mask_sse2<comp>(v, value_vec), first_tid+i, out+written);
+	}
+	return written + select_values_scalar<comp>(values+i, count-i, value, first_tid+i, out+written);
+}
+
+template<int comp>
+inline size_t select_values_sse2(const float* values, size_t count, float value, TID first_tid, TID* out){
+	const __m128 value_vec = _mm_set1_ps(value);
+	size_t written = 0;
+	size_t i = 0;
+	for(; i+4 <= count; i += 4){
+		__m128 v = _mm_loadu_ps(values+i);
+		written += write_mask_positions(compare_mask_sse2<comp>(v, value_vec), first_tid+i, out+written);
+	}
+	return written + select_values_scalar<comp>(values+i, count-i, value, first_tid+i, out+written);
+}
+
+/*! \brief writes first_tid+i to out for every values[i] fulfilling the predicate, returns the number of written TIDs (AVX2 implementation)*/
+template<int comp>
+__attribute__((target("avx2")))
+inline size_t select_values_avx2(const boost::int32_t* values, size_t count, boost::int32_t value, TID first_tid, TID* out){
+	const __m256i value_vec = _mm256_set1_epi32(value);
+	size_t written = 0;
+	size_t i = 0;
+	for(; i+8 <= count; i += 8){
+		__m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(values+i));
+		written += write_mask_positions(compare_mask_avx2<comp>(v, value_vec), first_tid+i, out+written);
+	}
+	return written + select_values_scalar<comp>(values+i, count-i, value, first_tid+i, out+written);
+}
+
+template<int comp>
+__attribute__((target("avx2")))
+inline size_t select_values_avx2(const float* values, size_t count, float value, TID first_tid, TID* out){
+	const __m256 value_vec = _mm256_set1_ps(value);
+	size_t written = 0;
+	size_t i = 0;
+	for(; i+8 <= count; i += 8){
+		__m256 v = _mm256_loadu_ps(values+i);
+		written += write_mask_positions(compare_mask_avx2<comp>(v, value_vec), first_tid+i, out+written);
+	}
+	return written + select_values_scalar<comp>(values+i, count-i, value, first_tid+i, out+written);
+}
+#endif
+
+/*! \brief writes first_tid+i to out for every values[i] fulfilling the predicate, returns the number of written TIDs, uses the fastest available kernel*/
+template<int comp, class T>
+inline size_t select_values_dispatch(const T* values, size_t count, const T& value, TID first_tid, TID* out){
+	return select_values_scalar<comp>(values, count, value, first_tid, out);
+}
+
+#ifdef COGADB_ENABLE_SIMD_KERNELS
+template<int comp>
+inline size_t select_values_dispatch(const boost::int32_t* values, size_t count, const boost::int32_t& value, TID first_tid, TID* out){
+	if(cpu_supports_avx2()){
+		return select_values_avx2<comp>(values, count, value, first_tid, out);
+	}
+	return select_values_sse2<comp>(values, count, value, first_tid, out);
+}
+
+template<int comp>
+inline size_t select_values_dispatch(const float* values, size_t count, const float& value, TID first_tid, TID* out){
+	if(cpu_supports_avx2()){
+		return select_values_avx2<comp>(values, count, value, first_tid, out);
+	}
+	return select_values_sse2<comp>(values, count, value, first_tid, out);
+}
+#endif
+
+/*! \brief number of values select_values() compares at once, their TIDs are written to a buffer on the stack*/
+const size_t SELECT_CHUNK_SIZE = 1024;
+
+/*! \brief appends first_tid+i to result for every values[i] fulfilling the predicate values[i] comp value
+ *  \details Plain int and float arrays are compared with SIMD kernels, all other types with the branch free scalar kernel.
+ *           The kernels write the TIDs of a chunk of SELECT_CHUNK_SIZE values into a local buffer, only the matching TIDs are
+ *           appended to result, so result does not grow with the number of scanned values.*/
+template<class T>
+inline void select_values(const T* values, size_t count, ValueComparator comp, const T& value, TID first_tid, std::vector<TID>& result){
+	TID buffer[SELECT_CHUNK_SIZE];
+	for(size_t begin = 0; begin < count; begin += SELECT_CHUNK_SIZE){
+		size_t chunk = std::min(SELECT_CHUNK_SIZE, count-begin);
+		size_t written = 0;
+		if(comp==EQUAL){
+			written = select_values_dispatch<EQUAL>(values+begin, chunk, value, first_tid+begin, buffer);
+		}else if(comp==LESSER){
+			written = select_values_dispatch<LESSER>(values+begin, chunk, value, first_tid+begin, buffer);
+		}else if(comp==GREATER){
+			written = select_values_dispatch<GREATER>(values+begin, chunk, value, first_tid+begin, buffer);
+		}
+		result.insert(result.end(), buffer, buffer+written);
+	}
+}
+
+/*! \brief returns a op b*/
+template<int op, class T>
+inline T compute_operation(const T& a, const T& b){
+	if(op==ADD) return a+b;
+	if(op==SUB) return a-b;
+	if(op==MUL) return a*b;
+	return a/b;
+}
+
+/*! \brief replaces every values[i] by values[i] op operand (scalar implementation)*/
+template<int op, class T>
+inline void apply_operation_scalar(T* values, size_t count, const T& operand){
+	for(size_t i = 0; i < count; i++){
+		values[i] = compute_operation<op>(values[i], operand);
+	}
+}
+
+#ifdef COGADB_ENABLE_SIMD_KERNELS
+/*! \brief replaces every values[i] by values[i] op operand (SSE2 implementation), SSE2 has no 32 bit integer multiplication and no integer division*/
+template<int op>
+inline void apply_operation_sse2(boost::int32_t* values, size_t count, boost::int32_t operand){
+	size_t i = 0;
+	if(op==ADD || op==SUB){
+		const __m128i operand_vec = _mm_set1_epi32(operand);
+		for(; i+4 <= count; i += 4){
+			__m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(values+i));
+			v = (op==ADD) ? _mm_add_epi32(v, operand_vec) : _mm_sub_epi32(v, operand_vec);
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(values+i), v);
+		}
+	}
+	apply_operation_scalar<op>(values+i, count-i, operand);
+}
+
+template<int op>
+inline void apply_operation_sse2(float* values, size_t count, float operand){
+	const __m128 operand_vec = _mm_set1_ps(operand);
+	size_t i = 0;
+	for(; i+4 <= count; i += 4){
+		__m128 v = _mm_loadu_ps(values+i);
+		if(op==ADD) v = _mm_add_ps(v, operand_vec);
+		else if(op==SUB) v = _mm_sub_ps(v, operand_vec);
+		else if(op==MUL) v = _mm_mul_ps(v, operand_vec);
+		else v = _mm_div_ps(v, operand_vec);
+		_mm_storeu_ps(values+i, v);
+	}
+	apply_operation_scalar<op>(values+i, count-i, operand);
+}
+
+/*! \brief replaces every values[i] by values[i] op operand (AVX2 implementation), integer divisions are computed by the scalar implementation*/
+template<int op>
+__attribute__((target("avx2")))
+inline void apply_operation_avx2(boost::int32_t* values, size_t count, boost::int32_t operand){
+	size_t i = 0;
+	if(op!=DIV){
+		const __m256i operand_vec = _mm256_set1_epi32(operand);
+		for(; i+8 <= count; i += 8){
+			__m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(values+i));
+			if(op==ADD) v = _mm256_add_epi32(v, operand_vec);
+			else if(op==SUB) v = _mm256_sub_epi32(v, operand_vec);
+			else v = _mm256_mullo_epi32(v, operand_vec);
+			_mm256_storeu_si256(reinterpret_cast<__m256i*>(values+i), v);
+		}
+	}
+	apply_operation_scalar<op>(values+i, count-i, operand);
+}
+
+template<int op>
+__attribute__((target("avx2")))
+inline void apply_operation_avx2(float* values, size_t count, float operand){
+	const __m256 operand_vec = _mm256_set1_ps(operand);
+	size_t i = 0;
+	for(; i+8 <= count; i += 8){
+		__m256 v = _mm256_loadu_ps(values+i);
+		if(op==ADD) v = _mm256_add_ps(v, operand_vec);
+		else if(op==SUB) v = _mm256_sub_ps(v, operand_vec);
+		else if(op==MUL) v = _mm256_mul_ps(v, operand_vec);
+		else v = _mm256_div_ps(v, operand_vec);
+		_mm256_storeu_ps(values+i, v);
+	}
+	apply_operation_scalar<op>(values+i, count-i, operand);
+}
+#endif
+
+/*! \brief replaces every values[i] by values[i] op operand, uses the fastest available kernel*/
+template<int op, class T>
+inline void apply_operation_dispatch(T* values, size_t count, const T& operand){
+	apply_operation_scalar<op>(values, count, operand);
+}
+
+#ifdef COGADB_ENABLE_SIMD_KERNELS
+template<int op>
+inline void apply_operation_dispatch(boost::int32_t* values, size_t count, const boost::int32_t& operand){
+	if(cpu_supports_avx2()){
+		apply_operation_avx2<op>(values, count, operand);
+	}else{
+		apply_operation_sse2<op>(values, count, operand);
+	}
+}
+
+template<int op>
+inline void apply_operation_dispatch(float* values, size_t count, const float& operand){
+	if(cpu_supports_avx2()){
+		apply_operation_avx2<op>(values, count, operand);
+	}else{
+		apply_operation_sse2<op>(values, count, operand);
+	}
+}
+#endif
+
+/*! \brief replaces every values[i] by values[i] op operand, e.g., values[i]+operand for ADD
+ *  \details Plain int and float arrays are processed with SIMD kernels, all other types with the scalar kernel.*/
+template<class T>
+inline void apply_operation(T* values, size_t count, ColumnAlgebraOperation op, const T& operand){
+	if(op==ADD){
+		apply_operation_dispatch<ADD>(values, count, operand);
+	}else if(op==SUB){
+		apply_operation_dispatch<SUB>(values, count, operand);
+	}else if(op==MUL){
+		apply_operation_dispatch<MUL>(values, count, operand);
+	}else if(op==DIV){
+		apply_operation_dispatch<DIV>(values, count, operand);
+	}
+}
+
+//numeric computations are undefined on strings
+inline void apply_operation(std::string*, size_t, ColumnAlgebraOperation, const std::string&){
+}
+
+/*! \brief replaces every values[i] by values[i] op operands[i] (scalar implementation)*/
+template<int op, class T>
+inline void apply_operation_scalar(T* values, const T* operands, size_t count){
+	for(size_t i = 0; i < count; i++){
+		values[i] = compute_operation<op>(values[i], operands[i]);
+	}
+}
+
+/*! \brief replaces every values[i] by values[i] op operands[i], e.g., values[i]+operands[i] for ADD*/
+template<class T>
+inline void apply_operation(T* values, const T* operands, size_t count, ColumnAlgebraOperation op){
+	if(op==ADD){
+		apply_operation_scalar<ADD>(values, operands, count);
+	}else if(op==SUB){
+		apply_operation_scalar<SUB>(values, operands, count);
+	}else if(op==MUL){
+		apply_operation_scalar<MUL>(values, operands, count);
+	}else if(op==DIV){
+		apply_operation_scalar<DIV>(values, operands, count);
+	}
+}
+
+}; //end namespace CogaDB
@@ -0,0 +1,189 @@
+#pragma once
+
+#include <vector>
+#include <algorithm>
+#include <iterator>
+#include <cstring>
+#include <boost/cstdint.hpp>
+#include <boost/thread.hpp>
+#include <boost/bind/bind.hpp>
+#include <core/base_column.hpp>
+
+namespace CoGaDB{
+
+/*!
+ *  \file sort_algorithms.hpp
+ *  \brief Sort algorithms used by the sort and join operators of the columns.
+ */
+
+/*! \brief ranges with fewer elements are sorted by a single thread*/
+const size_t PARALLEL_SORT_THRESHOLD = 65536;
+
+/*! \brief returns the number of threads used by the parallel algorithms, which is the number of hardware threads*/
+inline unsigned int get_number_of_threads(){
+	unsigned int number_of_threads = boost::thread::hardware_concurrency();
+	return number_of_threads ? number_of_threads : 1;
+}
+
+/*! \brief returns true in case [first, last) is sorted ascending with respect to comp, costs a single pass*/
+template<class RandomAccessIterator, class Compare>
+bool is_sorted_ascending(RandomAccessIterator first, RandomAccessIterator last, Compare comp){
+	for(RandomAccessIterator it = first; it != last && it+1 != last; ++it){
+		if(comp(*(it+1), *it)) return false;
+	}
+	return true;
+}
+
+/*! \brief sorts one chunk of parallel_sort()*/
+template<class RandomAccessIterator, class Compare>
+void sort_range(RandomAccessIterator first, RandomAccessIterator last, Compare comp){
+	std::sort(first, last, comp);
+}
+
+/*! \brief merges two neighbouring sorted chunks of parallel_sort()*/
+template<class RandomAccessIterator, class Compare>
+void merge_ranges(RandomAccessIterator first, RandomAccessIterator middle, RandomAccessIterator last, Compare comp){
+	std::inplace_merge(first, middle, last, comp);
+}
+
+/*! \brief sorts [first, last) with number_of_threads threads
+ *  \details The range is split into one chunk per thread, the chunks are sorted in parallel and then merged pairwise in
+ *           log2(number_of_threads) rounds, where the merges of a round run in parallel as well. Small ranges are sorted by the
+ *           calling thread only. Like std::sort, the algorithm is not stable.*/
+template<class RandomAccessIterator, class Compare>
+void parallel_sort(RandomAccessIterator first, RandomAccessIterator last, Compare comp, unsigned int number_of_threads = get_number_of_threads()){
+	size_t size = last - first;
+	if(number_of_threads <= 1 || size < PARALLEL_SORT_THRESHOLD){
+		std::sort(first, last, comp);
+		return;
+	}
+
+	std::vector<RandomAccessIterator> bounds;
+	for(unsigned int i = 0; i <= number_of_threads; i++){
+		bounds.push_back(first + (unsigned long long) size*i/number_of_threads);
+	}
+
+	boost::thread_group sorters;
+	for(unsigned int i = 0; i < number_of_threads; i++){
+		sorters.create_thread(boost::bind(&sort_range<RandomAccessIterator, Compare>, bounds[i], bounds[i+1], comp));
+	}
+	sorters.join_all();
+
+	//merge neighbouring chunks until a single sorted chunk is left
+	for(size_t width = 1; width < number_of_threads; width *= 2){
+		boost::thread_group mergers;
+		for(size_t i = 0; i + width < number_of_threads; i += 2*width){
+			size_t end = std::min<size_t>(i + 2*width, number_of_threads);
+			mergers.create_thread(boost::bind(&merge_ranges<RandomAccessIterator, Compare>, bounds[i], bounds[i+width], bounds[end], comp));
+		}
+		mergers.join_all();
+	}
+}
+
+template<class RandomAccessIterator>
+void parallel_sort(RandomAccessIterator first, RandomAccessIterator last){
+	parallel_sort(first, last, std::less<typename std::iterator_traits<RandomAccessIterator>::value_type>());
+}
+
+/*! \brief orders pairs of value and TID ascending by value, pairs with equal values by TID*/
+template<class T>
+struct ValueTIDLess{
+	bool operator()(const std::pair<T,TID>& a, const std::pair<T,TID>& b) const{
+		if(a.first < b.first) return true;
+		if(b.first < a.first) return false;
+		return a.second < b.second;
+	}
+};
+
+/*! \brief orders pairs of value and TID descending by value, pairs with equal values ascending by TID*/
+template<class T>
+struct ValueTIDGreater{
+	bool operator()(const std::pair<T,TID>& a, const std::pair<T,TID>& b) const{
+		if(b.first < a.first) return true;
+		if(a.first < b.first) return false;
+		return a.second < b.second;
+	}
+};
+
+/*! \brief sorts the keys with a stable LSD radix sort (8 bits per pass) and moves the TIDs along with them
+ *  \details Passes in which all keys have the same digit are skipped.*/
+inline void radix_sort(std::vector<boost::uint32_t>& keys, PositionList& tids){
+	std::vector<boost::uint32_t> key_buffer(keys.size());
+	PositionList tid_buffer(tids.size());
+	for(unsigned int shift = 0; shift < 32; shift += 8){
+		size_t histogram[257] = {0};
+		for(size_t i = 0; i < keys.size(); i++){
+			histogram[((keys[i] >> shift) & 0xFF) + 1]++;
+		}
+		bool single_digit = false;
+		for(unsigned int digit = 1; digit <= 256; digit++){
+			if(histogram[digit] == keys.size()) single_digit = true;
+			histogram[digit] += histogram[digit-1];
+		}
+		if(single_digit) continue;
+
+		for(size_t i = 0; i < keys.size(); i++){
+			size_t position = histogram[(keys[i] >> shift) & 0xFF]++;
+			key_buffer[position] = keys[i];
+			tid_buffer[position] = tids[i];
+		}
+		keys.swap(key_buffer);
+		tids.swap(tid_buffer);
+	}
+}
+
+/*! \brief maps an int to an unsigned key with the same order*/
+inline boost::uint32_t get_sortable_bits(boost::int32_t value){
+	return boost::uint32_t(value) ^ 0x80000000u;
+}
+
+/*! \brief maps a float to an unsigned key with the same order
+ *  \details The sign bit of positive numbers is set, all bits of negative numbers are inverted, so their order is reversed.*/
+inline boost::uint32_t get_sortable_bits(float value){
+	boost::uint32_t bits;
+	std::memcpy(&bits, &value, sizeof(bits));
+	return (bits & 0x80000000u) ? ~bits : (bits | 0x80000000u);
+}
+
+/*! \brief radix sort of values by their sortable bits, returns the TIDs in sorted order, equal values keep their TID order*/
+template<class T>
+void radix_sort_values(const T* values, size_t count, SortOrder order, PositionList& result){
+	std::vector<boost::uint32_t> keys(count);
+	PositionList tids(count);
+	for(size_t i = 0; i < count; i++){
+		keys[i] = (order == DESCENDING) ? ~get_sortable_bits(values[i]) : get_sortable_bits(values[i]);
+		tids[i] = i;
+	}
+	radix_sort(keys, tids);
+	result.insert(result.end(), tids.begin(), tids.end());
+}
+
+/*! \brief sorts values and returns the TIDs in sorted order, equal values keep their TID order
+ *  \details Other types than int and float are sorted as pairs of value and TID with parallel_sort().*/
+template<class T>
+void sort_values(const T* values, size_t count, SortOrder order, PositionList& result){
+	std::vector<std::pair<T,TID> > pairs;
+	pairs.reserve(count);
+	for(size_t i = 0; i < count; i++){
+		pairs.push_back(std::pair<T,TID>(values[i], i));
+	}
+	if(order == DESCENDING){
+		parallel_sort(pairs.begin(), pairs.end(), ValueTIDGreater<T>());
+	}else{
+		parallel_sort(pairs.begin(), pairs.end(), ValueTIDLess<T>());
+	}
+	for(size_t i = 0; i < pairs.size(); i++){
+		result.push_back(pairs[i].second);
+	}
+}
+
+inline void sort_values(const boost::int32_t* values, size_t count, SortOrder order, PositionList& result){
+	radix_sort_values(values, count, order, result);
+}
+
+inline void sort_values(const float* values, size_t count, SortOrder order, PositionList& result){
+	radix_sort_values(values, count, order, result);
+}
+
+
+}; //end namespace CogaDB
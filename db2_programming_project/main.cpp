@@ -1,4 +1,5 @@
 #include <string>
+#include <set>
 #include <core/global_definitions.hpp>
 #include <core/base_column.hpp>
 #include <core/column_base_typed.hpp>
@@ -9,6 +10,13 @@
 #include <compression/dictionary_compressed_column.hpp>
 #include <compression/run_length_compressed_column.hpp>
 #include <compression/bit_vector_compressed_column.h>
+#include <compression/delta_compressed_column.h>
+#include <compression/pfor_compressed_column.hpp>
+#include <compression/frequency_partitioned_column.hpp>
+#include <compression/xor_compressed_column.hpp>
+#include <compression/front_coded_compressed_column.hpp>
+#include <compression/cascaded_compressed_column.hpp>
+#include <compression/compression_advisor.hpp>
 
 #include  "unittest.hpp"
 
@@ -35,74 +43,667 @@ int main(){
 	}
 	std::cout << "Unitests Passed!" << std::endl;
 
-//	/****** BULK UPDATE TEST ******/
-//	{
-//		std::cout << "BULK UPDATE TEST..."; // << std::endl;
-//		boost::shared_ptr<Column<int> > uncompressed_col (new Column<int>("int column",INT));
-//		boost::shared_ptr<Column<int> > compressed_col (new Column<int>("int column",INT));
-//		//boost::shared_ptr<DictionaryCompressedColumn<int> > compressed_col (new DictionaryCompressedColumn<int>("compressed int column",INT));
-
-
-//		uncompressed_col->insert(reference_data.begin(),reference_data.end()); 
-//		compressed_col->insert(reference_data.begin(),reference_data.end()); 
-
-//		bool result = *(boost::static_pointer_cast<ColumnBaseTyped<int> >(uncompressed_col))==*(boost::static_pointer_cast<ColumnBaseTyped<int> >(compressed_col));
-//		if(!result){ 
-//			std::cerr << std::endl << "operator== TEST FAILED!" << std::endl;	
-//			return false;
-//		}
-//		PositionListPtr tids (new PositionList());
-//		int new_value=rand()%100;
-//	   for(unsigned int i=0;i<10;i++){
-//	 		tids->push_back(rand()%uncompressed_col->size());
-//	   }
-//		
-//		uncompressed_col->update(tids,new_value); 
-//		compressed_col->update(tids,new_value); 
-
-//		result = *(boost::static_pointer_cast<ColumnBaseTyped<int> >(uncompressed_col))==*(boost::static_pointer_cast<ColumnBaseTyped<int> >(compressed_col));
-//		if(!result){
-//			 std::cerr << std::endl << "BULK UPDATE TEST FAILED!" << std::endl;	
-//			 return false;	
-//		}
-//		std::cout << "SUCCESS"<< std::endl;	
-
-//	}
-
-//	/****** BULK DELETE TEST ******/
-//	{
-//		std::cout << "BULK DELETE TEST..."; // << std::endl;
-//		boost::shared_ptr<Column<int> > uncompressed_col (new Column<int>("int column",INT));
-//		boost::shared_ptr<Column<int> > compressed_col (new Column<int>("int column",INT));
-
-//		//boost::shared_ptr<DictionaryCompressedColumn<int> > compressed_col (new DictionaryCompressedColumn<int>("compressed int column",INT));
-
-//		uncompressed_col->insert(reference_data.begin(),reference_data.end()); 
-//		compressed_col->insert(reference_data.begin(),reference_data.end()); 
-
-//		bool result = *(boost::static_pointer_cast<ColumnBaseTyped<int> >(uncompressed_col))==*(boost::static_pointer_cast<ColumnBaseTyped<int> >(compressed_col));
-//		if(!result){ 
-//			std::cerr << std::endl << "operator== TEST FAILED!" << std::endl;	
-//			return false;
-//		}
-
-//		PositionListPtr tids (new PositionList());
-
-//	   for(unsigned int i=0;i<10;i++){
-//	 		tids->push_back(rand()%uncompressed_col->size());
-//	   }
-//		
-//		uncompressed_col->remove(tids); 
-//		compressed_col->remove(tids); 
-
-//		result = *(boost::static_pointer_cast<ColumnBaseTyped<int> >(uncompressed_col))==*(boost::static_pointer_cast<ColumnBaseTyped<int> >(compressed_col));
-//		if(!result){
-//			 std::cerr << "BULK DELETE TEST FAILED!" << std::endl;	
-//			 return false;	
-//		}
-//		std::cout << "SUCCESS"<< std::endl;	
-
-//	}
+    if(!unittest<DictionaryCompressedColumn, int>()){
+		std::cout << "At least one Unittest Failed!" << std::endl;
+		return -1;
+	}
+	std::cout << "Unitests Passed!" << std::endl;
+
+    if(!unittest<DictionaryCompressedColumn, float>()){
+		std::cout << "At least one Unittest Failed!" << std::endl;
+		return -1;
+	}
+	std::cout << "Unitests Passed!" << std::endl;
+
+    if(!unittest<DictionaryCompressedColumn, std::string>()){
+		std::cout << "At least one Unittest Failed!" << std::endl;
+		return -1;
+	}
+	std::cout << "Unitests Passed!" << std::endl;
+
+    if(!unittest<RunLengthCompressedColumn, int>()){
+		std::cout << "At least one Unittest Failed!" << std::endl;
+		return -1;
+	}
+	std::cout << "Unitests Passed!" << std::endl;
+
+    if(!unittest<RunLengthCompressedColumn, float>()){
+		std::cout << "At least one Unittest Failed!" << std::endl;
+		return -1;
+	}
+	std::cout << "Unitests Passed!" << std::endl;
+
+    if(!unittest<RunLengthCompressedColumn, std::string>()){
+		std::cout << "At least one Unittest Failed!" << std::endl;
+		return -1;
+	}
+	std::cout << "Unitests Passed!" << std::endl;
+
+    if(!unittest<DeltaCompressedColumn, int>()){
+		std::cout << "At least one Unittest Failed!" << std::endl;
+		return -1;
+	}
+	std::cout << "Unitests Passed!" << std::endl;
+
+    if(!unittest<PForCompressedColumn, int>()){
+		std::cout << "At least one Unittest Failed!" << std::endl;
+		return -1;
+	}
+	std::cout << "Unitests Passed!" << std::endl;
+
+    if(!unittest<FrequencyPartitionedColumn, int>()){
+		std::cout << "At least one Unittest Failed!" << std::endl;
+		return -1;
+	}
+	std::cout << "Unitests Passed!" << std::endl;
+
+    if(!unittest<FrequencyPartitionedColumn, float>()){
+		std::cout << "At least one Unittest Failed!" << std::endl;
+		return -1;
+	}
+	std::cout << "Unitests Passed!" << std::endl;
+
+    if(!unittest<FrequencyPartitionedColumn, std::string>()){
+		std::cout << "At least one Unittest Failed!" << std::endl;
+		return -1;
+	}
+	std::cout << "Unitests Passed!" << std::endl;
+
+    if(!unittest<XorCompressedColumn, float>()){
+		std::cout << "At least one Unittest Failed!" << std::endl;
+		return -1;
+	}
+	std::cout << "Unitests Passed!" << std::endl;
+
+    if(!unittest<FrontCodedCompressedColumn, std::string>()){
+		std::cout << "At least one Unittest Failed!" << std::endl;
+		return -1;
+	}
+	std::cout << "Unitests Passed!" << std::endl;
+
+    if(!unittest<CascadedCompressedColumn, int>()){
+		std::cout << "At least one Unittest Failed!" << std::endl;
+		return -1;
+	}
+	std::cout << "Unitests Passed!" << std::endl;
+
+    if(!unittest<CascadedCompressedColumn, float>()){
+		std::cout << "At least one Unittest Failed!" << std::endl;
+		return -1;
+	}
+	std::cout << "Unitests Passed!" << std::endl;
+
+    if(!unittest<CascadedCompressedColumn, std::string>()){
+		std::cout << "At least one Unittest Failed!" << std::endl;
+		return -1;
+	}
+	std::cout << "Unitests Passed!" << std::endl;
+
+	/****** COMPRESSION ADVISOR TEST ******/
+	{
+		std::cout << "COMPRESSION ADVISOR TEST..."; // << std::endl;
+		//long runs of equal values, run length encoding has to win
+		std::vector<int> values;
+		for(int i=0;i<10000;i++){
+			values.push_back(i/1000);
+		}
+		EncodingEstimates estimates;
+		ColumnPtr col = createColumn(INT, "advised int column", values, &estimates);
+		boost::shared_ptr<ColumnBaseTyped<int> > typed_col = boost::static_pointer_cast<ColumnBaseTyped<int> >(col);
+		if(estimates.empty() || estimates.front().encoding != RUN_LENGTH_ENCODING || !boost::dynamic_pointer_cast<RunLengthCompressedColumn<int> >(col)){
+			std::cout << "FAILED! The advisor chose " << (estimates.empty() ? std::string("nothing") : getEncodingName(estimates.front().encoding)) << std::endl;
+			return -1;
+		}
+		for(unsigned int i=0;i<values.size();i++){
+			if((*typed_col)[i]!=values[i]){
+				std::cout << "FAILED! Wrong value in advised column at position " << i << std::endl;
+				return -1;
+			}
+		}
+		std::cout << "SUCCESS" << std::endl;
+	}
+
+	/****** ROARING BITMAP TEST ******/
+	{
+		std::cout << "ROARING BITMAP TEST..."; // << std::endl;
+		//chunk c holds sparse values (array), dense values (bitset) or a few long runs (run) in each bitmap, so the first nine
+		//chunks cover all combinations of container types, the runs touch the chunk boundaries, chunks 9 and 10 exist only once
+		std::set<TID> reference[2];
+		RoaringBitmap bitmaps[2];
+		for(TID chunk=0;chunk<11;chunk++){
+			for(unsigned int b=0;b<2;b++){
+				if((chunk==9 && b==1) || (chunk==10 && b==0)) continue;
+				unsigned int container_type = (chunk>=9) ? 2 : ((b==0) ? chunk%3 : chunk/3);
+				TID base = chunk*RoaringContainer::CHUNK_SIZE;
+				if(container_type==0){
+					for(int i=0;i<1000;i++) reference[b].insert(base+rand()%65536);
+				}else if(container_type==1){
+					for(int i=0;i<30000;i++) reference[b].insert(base+rand()%65536);
+				}else{
+					TID starts[] = {0, TID(rand()%1000+500), TID(rand()%10000+20000), TID(rand()%1000+60000)};
+					TID ends[] = {TID(rand()%100+1), TID(rand()%10000+5000), TID(rand()%10000+35000), 65536};
+					for(unsigned int r=0;r<4;r++){
+						for(TID value=starts[r];value<ends[r];value++) reference[b].insert(base+value);
+					}
+				}
+			}
+		}
+		for(unsigned int b=0;b<2;b++){
+			for(std::set<TID>::const_iterator it=reference[b].begin();it!=reference[b].end();++it) bitmaps[b].add(*it);
+			bitmaps[b].runOptimize();
+		}
+		std::vector<TID> expected[4];
+		std::set_intersection(reference[0].begin(),reference[0].end(),reference[1].begin(),reference[1].end(),std::back_inserter(expected[0]));
+		std::set_union(reference[0].begin(),reference[0].end(),reference[1].begin(),reference[1].end(),std::back_inserter(expected[1]));
+		std::set_difference(reference[0].begin(),reference[0].end(),reference[1].begin(),reference[1].end(),std::back_inserter(expected[2]));
+		std::set_difference(reference[1].begin(),reference[1].end(),reference[0].begin(),reference[0].end(),std::back_inserter(expected[3]));
+		RoaringBitmap results[] = {bitmaps[0] & bitmaps[1], bitmaps[0] | bitmaps[1], bitmaps[0].andNot(bitmaps[1]), bitmaps[1].andNot(bitmaps[0])};
+		const char* operations[] = {"AND", "OR", "ANDNOT", "reversed ANDNOT"};
+		for(unsigned int o=0;o<4;o++){
+			std::vector<TID> positions;
+			results[o].getPositions(positions);
+			if(positions!=expected[o] || results[o].cardinality()!=expected[o].size()){
+				std::cout << "FAILED! " << operations[o] << " returned " << positions.size() << " positions instead of " << expected[o].size() << std::endl;
+				return -1;
+			}
+		}
+		std::cout << "SUCCESS" << std::endl;
+	}
+
+	/****** SORT TEST ******/
+	{
+		std::cout << "SORT TEST..."; // << std::endl;
+		boost::shared_ptr<Column<int> > int_col (new Column<int>("int column",INT));
+		boost::shared_ptr<Column<std::string> > string_col (new Column<std::string>("string column",VARCHAR));
+		for(int i=0;i<1000;i++){
+			int_col->insert(rand()%200-100);
+			string_col->insert(get_rand_value<std::string>().substr(0,2));
+		}
+		//ascending and descending, equal values have to keep the order of their TIDs
+		for(int order=0;order<2;order++){
+			PositionListPtr int_tids = int_col->sort(SortOrder(order));
+			PositionListPtr string_tids = string_col->sort(SortOrder(order));
+			if(int_tids->size()!=int_col->size() || string_tids->size()!=string_col->size()){
+				std::cout << "FAILED! Sort returned the wrong number of TIDs" << std::endl;
+				return -1;
+			}
+			for(unsigned int i=1;i<int_col->size();i++){
+				int a=(*int_col)[(*int_tids)[i-1]], b=(*int_col)[(*int_tids)[i]];
+				const std::string& c=(*string_col)[(*string_tids)[i-1]];
+				const std::string& d=(*string_col)[(*string_tids)[i]];
+				bool int_ordered = (order==ASCENDING) ? a<b : a>b;
+				bool string_ordered = (order==ASCENDING) ? c<d : c>d;
+				if((!int_ordered && (a!=b || (*int_tids)[i-1]>(*int_tids)[i])) || (!string_ordered && (c!=d || (*string_tids)[i-1]>(*string_tids)[i]))){
+					std::cout << "FAILED! Wrong sort order at position " << i << std::endl;
+					return -1;
+				}
+			}
+		}
+		std::cout << "SUCCESS" << std::endl;
+	}
+
+	/****** COMPRESSED SORT TEST ******/
+	{
+		std::cout << "COMPRESSED SORT TEST..."; // << std::endl;
+		boost::shared_ptr<Column<int> > reference_col (new Column<int>("reference int column",INT));
+		boost::shared_ptr<ColumnBaseTyped<int> > sort_cols[] = {
+			boost::shared_ptr<ColumnBaseTyped<int> >(new DictionaryCompressedColumn<int>("dictionary int column",INT)),
+			boost::shared_ptr<ColumnBaseTyped<int> >(new DictionaryCompressedColumn<int>("order preserving dictionary int column",INT,true)),
+			boost::shared_ptr<ColumnBaseTyped<int> >(new BitVectorCompressedColumn<int>("bitvector int column",INT))};
+		const unsigned int number_of_sort_cols = sizeof(sort_cols)/sizeof(sort_cols[0]);
+		//many duplicates, inserted out of order, so the dictionaries are not sorted
+		for(int i=0;i<1000;i++){
+			int value = (i%2==0) ? rand()%50 : 100-rand()%50;
+			reference_col->insert(value);
+			for(unsigned int c=0;c<number_of_sort_cols;c++) sort_cols[c]->insert(value);
+		}
+		//updates with new values leave pending dictionary entries behind
+		for(TID tid=0;tid<1000;tid+=97){
+			int value = rand()%150-25;
+			(*reference_col)[tid] = value;
+			for(unsigned int c=0;c<number_of_sort_cols;c++) sort_cols[c]->update(tid,boost::any(value));
+		}
+		for(int order=0;order<2;order++){
+			PositionListPtr expected_tids = reference_col->sort(SortOrder(order));
+			for(unsigned int c=0;c<number_of_sort_cols;c++){
+				PositionListPtr tids = sort_cols[c]->sort(SortOrder(order));
+				if(tids->size()!=reference_col->size()){
+					std::cout << "FAILED! " << sort_cols[c]->getName() << " returned the wrong number of TIDs" << std::endl;
+					return -1;
+				}
+				for(unsigned int i=0;i<tids->size();i++){
+					//equal values have to keep the order of their TIDs in both directions, like Column<T>::sort
+					bool ordered = true;
+					if(i>0){
+						int a=(*reference_col)[(*tids)[i-1]], b=(*reference_col)[(*tids)[i]];
+						ordered = ((order==ASCENDING) ? a<b : a>b) || (a==b && (*tids)[i-1]<(*tids)[i]);
+					}
+					if(!ordered || (*tids)[i]!=(*expected_tids)[i]){
+						std::cout << "FAILED! " << sort_cols[c]->getName() << " has the wrong sort order at position " << i << std::endl;
+						return -1;
+					}
+				}
+			}
+		}
+		std::cout << "SUCCESS" << std::endl;
+	}
+
+	/****** JOIN TEST ******/
+	{
+		std::cout << "JOIN TEST..."; // << std::endl;
+		//duplicates on both sides, the left column is sorted, so its sort phase is skipped
+		boost::shared_ptr<Column<int> > left_col (new Column<int>("left int column",INT));
+		boost::shared_ptr<Column<int> > right_col (new Column<int>("right int column",INT));
+		for(int i=0;i<1000;i++){
+			left_col->insert(i/10);
+			if(i<600) right_col->insert(rand()%150);
+		}
+		PositionListPairPtr expected = left_col->nested_loop_join(right_col);
+		std::vector<std::pair<TID,TID> > expected_pairs;
+		for(unsigned int i=0;i<expected->first->size();i++){
+			expected_pairs.push_back(std::make_pair((*expected->first)[i],(*expected->second)[i]));
+		}
+		std::sort(expected_pairs.begin(),expected_pairs.end());
+		//join in both directions, the smaller right column is the build side of the hash join in both cases
+		ColumnPtr join_inputs[] = {right_col, left_col};
+		for(unsigned int run=0;run<4;run++){
+			boost::shared_ptr<ColumnBaseTyped<int> > build_col = boost::static_pointer_cast<ColumnBaseTyped<int> >(join_inputs[run/2]);
+			PositionListPairPtr result = (run%2==0) ? build_col->sort_merge_join(join_inputs[1-run/2]) : build_col->hash_join(join_inputs[1-run/2]);
+			std::vector<std::pair<TID,TID> > result_pairs;
+			for(unsigned int i=0;i<result->first->size();i++){
+				//normalize to (TID of left_col, TID of right_col)
+				if(run/2==0){
+					result_pairs.push_back(std::make_pair((*result->second)[i],(*result->first)[i]));
+				}else{
+					result_pairs.push_back(std::make_pair((*result->first)[i],(*result->second)[i]));
+				}
+			}
+			std::sort(result_pairs.begin(),result_pairs.end());
+			if(result_pairs!=expected_pairs){
+				std::cout << "FAILED! " << ((run%2==0) ? "Sort merge join" : "Hash join") << " returned " << result_pairs.size() << " pairs instead of " << expected_pairs.size() << std::endl;
+				return -1;
+			}
+		}
+		std::cout << "SUCCESS" << std::endl;
+	}
+
+	/****** SKEWED JOIN TEST ******/
+	{
+		std::cout << "SKEWED JOIN TEST..."; // << std::endl;
+		//the smaller build side consists of four hot keys and a few unique ones, most probe rows find no match
+		boost::shared_ptr<Column<int> > skewed_col (new Column<int>("skewed int column",INT));
+		boost::shared_ptr<Column<int> > probe_col (new Column<int>("probe int column",INT));
+		for(int i=0;i<20000;i++){
+			skewed_col->insert((i%50==0) ? 1000+i : rand()%4);
+		}
+		for(int i=0;i<50000;i++){
+			probe_col->insert((i%250==0) ? rand()%4 : ((i%250==1) ? 1000+50*(rand()%400) : 100000+i));
+		}
+		//the pairs are ordered by the TIDs of the right column and then by the TIDs of the left column
+		ColumnPtr join_inputs[] = {skewed_col, probe_col};
+		for(unsigned int run=0;run<2;run++){
+			boost::shared_ptr<Column<int> > left_col = boost::static_pointer_cast<Column<int> >(join_inputs[run]);
+			boost::shared_ptr<Column<int> > right_col = boost::static_pointer_cast<Column<int> >(join_inputs[1-run]);
+			std::map<int, PositionList> left_tids_by_key;
+			for(TID left_tid=0;left_tid<left_col->size();left_tid++){
+				left_tids_by_key[(*left_col)[left_tid]].push_back(left_tid);
+			}
+			PositionList expected_left;
+			PositionList expected_right;
+			for(TID right_tid=0;right_tid<right_col->size();right_tid++){
+				std::map<int, PositionList>::const_iterator it = left_tids_by_key.find((*right_col)[right_tid]);
+				if(it==left_tids_by_key.end()) continue;
+				expected_left.insert(expected_left.end(),it->second.begin(),it->second.end());
+				expected_right.insert(expected_right.end(),it->second.size(),right_tid);
+			}
+			PositionListPairPtr result = left_col->hash_join(right_col);
+			if(*result->first!=expected_left || *result->second!=expected_right){
+				std::cout << "FAILED! Hash join returned " << result->first->size() << " pairs instead of " << expected_left.size() << " or a wrong order" << std::endl;
+				return -1;
+			}
+		}
+		std::cout << "SUCCESS" << std::endl;
+	}
+
+	/****** PARALLEL SELECTION TEST ******/
+	{
+		std::cout << "PARALLEL SELECTION TEST..."; // << std::endl;
+		//more than four morsels, so each of the four threads scans at least one morsel
+		const unsigned int number_of_rows = 4*MORSEL_SIZE+1000;
+		boost::shared_ptr<ColumnBaseTyped<int> > int_cols[] = {
+			boost::shared_ptr<ColumnBaseTyped<int> >(new Column<int>("int column",INT)),
+			boost::shared_ptr<ColumnBaseTyped<int> >(new DictionaryCompressedColumn<int>("dictionary int column",INT)),
+			boost::shared_ptr<ColumnBaseTyped<int> >(new DictionaryCompressedColumn<int>("order preserving dictionary int column",INT,true)),
+			boost::shared_ptr<ColumnBaseTyped<int> >(new RunLengthCompressedColumn<int>("run length int column",INT)),
+			boost::shared_ptr<ColumnBaseTyped<int> >(new BitVectorCompressedColumn<int>("bit vector int column",INT)),
+			boost::shared_ptr<ColumnBaseTyped<int> >(new DeltaCompressedColumn<int>("delta int column",INT)),
+			boost::shared_ptr<ColumnBaseTyped<int> >(new PForCompressedColumn<int>("pfor int column",INT)),
+			boost::shared_ptr<ColumnBaseTyped<int> >(new FrequencyPartitionedColumn<int>("frequency partitioned int column",INT)),
+			boost::shared_ptr<ColumnBaseTyped<int> >(new CascadedCompressedColumn<int>("cascaded int column",INT))};
+		boost::shared_ptr<ColumnBaseTyped<float> > float_col (new XorCompressedColumn<float>("xor float column",FLOAT));
+		boost::shared_ptr<ColumnBaseTyped<std::string> > string_col (new FrontCodedCompressedColumn<std::string>("front coded string column",VARCHAR));
+		//runs for the run length and delta encodings, mixed with scattered outliers
+		std::vector<int> int_values;
+		for(unsigned int i=0;i<number_of_rows;i++){
+			int_values.push_back(i%11==0 ? rand()%1000 : int(i/700));
+			for(unsigned int c=0;c<sizeof(int_cols)/sizeof(int_cols[0]);c++) int_cols[c]->insert(int_values.back());
+			float_col->insert(float(int_values.back())/4);
+			string_col->insert(get_rand_value<std::string>().substr(0,3));
+		}
+		std::vector<int> int_comparison_values;
+		int_comparison_values.push_back(int_values[rand()%number_of_rows]);
+		int_comparison_values.push_back(int(number_of_rows/1400));
+		int_comparison_values.push_back(-1);
+		int_comparison_values.push_back(1000);
+		std::vector<float> float_comparison_values;
+		float_comparison_values.push_back(float(int_values[rand()%number_of_rows])/4);
+		float_comparison_values.push_back(10.1f);
+		std::vector<std::string> string_comparison_values;
+		string_comparison_values.push_back(get_rand_value<std::string>().substr(0,3));
+		string_comparison_values.push_back(get_rand_value<std::string>().substr(0,1));
+		for(unsigned int c=0;c<sizeof(int_cols)/sizeof(int_cols[0]);c++){
+			if(!test_parallel_selection(int_cols[c], int_comparison_values)){
+				std::cout << "FAILED!" << std::endl;
+				return -1;
+			}
+		}
+		if(!test_parallel_selection(float_col, float_comparison_values) || !test_parallel_selection(string_col, string_comparison_values)){
+			std::cout << "FAILED!" << std::endl;
+			return -1;
+		}
+		std::cout << "SUCCESS" << std::endl;
+	}
+
+	/****** PREFIX SELECTION TEST ******/
+	{
+		std::cout << "PREFIX SELECTION TEST..."; // << std::endl;
+		boost::shared_ptr<FrontCodedCompressedColumn<std::string> > front_coded_col (new FrontCodedCompressedColumn<std::string>("front coded string column",VARCHAR));
+		//all strings over the characters 'a', 'b' and 0xFF up to length four, 0xFF is the character prefix_selection() cannot increment
+		const char characters[] = {'a', 'b', char(0xFF)};
+		std::vector<std::string> distinct_values(1, std::string());
+		for(unsigned int i=0;i<distinct_values.size();i++){
+			if(distinct_values[i].size()<4){
+				for(unsigned int c=0;c<3;c++) distinct_values.push_back(distinct_values[i]+characters[c]);
+			}
+		}
+		//the 65th distinct string triggers a rebuild of the dictionary, the following ones stay in the pending area
+		std::vector<std::string> values(distinct_values);
+		values.push_back("ac");
+		values.push_back(std::string("a\xFF") + "c");
+		values.push_back(std::string("\xFF\xFF") + "c");
+		for(int i=0;i<3000;i++){
+			values.push_back(distinct_values[rand()%distinct_values.size()]);
+		}
+		for(unsigned int i=0;i<values.size();i++){
+			front_coded_col->insert(values[i]);
+		}
+		std::string prefixes[] = {"", "a", "ab", "ac", "c", "zz", "abababab", "a\xFF", "\xFF", "\xFF\xFF", "\xFF\xFF\xFF\xFF", "b\xFF\xFF", "a\xFF" "c", "\xFF\xFF" "c"};
+		for(unsigned int p=0;p<sizeof(prefixes)/sizeof(prefixes[0]);p++){
+			PositionList expected;
+			for(TID tid=0;tid<values.size();tid++){
+				if(values[tid].compare(0, prefixes[p].size(), prefixes[p])==0) expected.push_back(tid);
+			}
+			PositionListPtr tids = front_coded_col->prefix_selection(prefixes[p]);
+			if(*tids!=expected){
+				std::cout << "FAILED! Wrong result for prefix number " << p << std::endl;
+				return -1;
+			}
+		}
+		std::cout << "SUCCESS" << std::endl;
+	}
+
+	/****** PFOR AGGREGATION TEST ******/
+	{
+		std::cout << "PFOR AGGREGATION TEST..."; // << std::endl;
+		//the sum does not fit into an int
+		PForCompressedColumn<int> col("pfor aggregation int column",INT);
+		boost::int64_t expected_sum = 0;
+		int expected_min = 0;
+		int expected_max = 0;
+		for(int i=0;i<3000;i++){
+			int value = (i<1000) ? ((i%2==0) ? 2000000000 : -5) : rand()%1000-500;
+			col.insert(value);
+			expected_sum += value;
+			expected_min = (i==0) ? value : std::min(expected_min, value);
+			expected_max = (i==0) ? value : std::max(expected_max, value);
+		}
+		if(col.sum()!=expected_sum || col.aggregate(SUM)!=expected_sum || col.aggregate(MIN)!=expected_min || col.aggregate(MAX)!=expected_max){
+			std::cout << "FAILED! SUM " << col.aggregate(SUM) << " MIN " << col.aggregate(MIN) << " MAX " << col.aggregate(MAX) << std::endl;
+			return -1;
+		}
+		PForCompressedColumn<int> empty_col("empty pfor aggregation int column",INT);
+		if(empty_col.aggregate(SUM)!=0 || empty_col.aggregate(MIN)!=0 || empty_col.aggregate(MAX)!=0){
+			std::cout << "FAILED! Aggregation of an empty column is not zero" << std::endl;
+			return -1;
+		}
+		std::cout << "SUCCESS" << std::endl;
+	}
+
+	/****** COLUMN ALGEBRA TEST ******/
+	{
+		std::cout << "COLUMN ALGEBRA TEST..."; // << std::endl;
+		//the division merges values, so the compressed columns have to merge codes, runs and bitmaps
+		boost::shared_ptr<ColumnBaseTyped<int> > cols[] = {
+			boost::shared_ptr<ColumnBaseTyped<int> >(new Column<int>("int column",INT)),
+			boost::shared_ptr<ColumnBaseTyped<int> >(new DictionaryCompressedColumn<int>("dictionary int column",INT,true)),
+			boost::shared_ptr<ColumnBaseTyped<int> >(new RunLengthCompressedColumn<int>("run length int column",INT)),
+			boost::shared_ptr<ColumnBaseTyped<int> >(new BitVectorCompressedColumn<int>("bit vector int column",INT)),
+			boost::shared_ptr<ColumnBaseTyped<int> >(new DeltaCompressedColumn<int>("delta int column",INT)),
+			boost::shared_ptr<ColumnBaseTyped<int> >(new PForCompressedColumn<int>("pfor int column",INT)),
+			boost::shared_ptr<ColumnBaseTyped<int> >(new FrequencyPartitionedColumn<int>("frequency partitioned int column",INT)),
+			boost::shared_ptr<ColumnBaseTyped<int> >(new CascadedCompressedColumn<int>("cascaded int column",INT))};
+		const unsigned int number_of_columns = sizeof(cols)/sizeof(cols[0]);
+		std::vector<int> values;
+		for(int i=0;i<2000;i++){
+			values.push_back(i%7==0 ? rand()%50 : i/100);
+		}
+		for(unsigned int c=0;c<number_of_columns;c++){
+			for(unsigned int i=0;i<values.size();i++){
+				cols[c]->insert(values[i]);
+			}
+			if(!cols[c]->multiply(boost::any(-3)) || !cols[c]->add(boost::any(7)) || !cols[c]->division(boost::any(4)) || !cols[c]->minus(boost::any(1))){
+				std::cout << "FAILED! Operation rejected by column " << cols[c]->getName() << std::endl;
+				return -1;
+			}
+		}
+		for(unsigned int i=0;i<values.size();i++){
+			values[i] = (values[i]*-3+7)/4-1;
+		}
+		for(unsigned int c=0;c<number_of_columns;c++){
+			for(unsigned int i=0;i<values.size();i++){
+				if((*cols[c])[i]!=values[i]){
+					std::cout << "FAILED! Wrong value in column " << cols[c]->getName() << " at position " << i << std::endl;
+					return -1;
+				}
+			}
+			if(cols[c]->selection(boost::any(values[0]),EQUAL)->size()!=size_t(std::count(values.begin(),values.end(),values[0]))){
+				std::cout << "FAILED! Wrong selection result for column " << cols[c]->getName() << std::endl;
+				return -1;
+			}
+		}
+		std::cout << "SUCCESS" << std::endl;
+	}
+
+	/****** COLUMN VECTOR ALGEBRA TEST ******/
+	{
+		std::cout << "COLUMN VECTOR ALGEBRA TEST..."; // << std::endl;
+		boost::shared_ptr<ColumnBaseTyped<int> > cols[] = {
+			boost::shared_ptr<ColumnBaseTyped<int> >(new Column<int>("int column",INT)),
+			boost::shared_ptr<ColumnBaseTyped<int> >(new DictionaryCompressedColumn<int>("dictionary int column",INT)),
+			boost::shared_ptr<ColumnBaseTyped<int> >(new DictionaryCompressedColumn<int>("order preserving dictionary int column",INT,true)),
+			boost::shared_ptr<ColumnBaseTyped<int> >(new RunLengthCompressedColumn<int>("run length int column",INT)),
+			boost::shared_ptr<ColumnBaseTyped<int> >(new BitVectorCompressedColumn<int>("bit vector int column",INT)),
+			boost::shared_ptr<ColumnBaseTyped<int> >(new DeltaCompressedColumn<int>("delta int column",INT)),
+			boost::shared_ptr<ColumnBaseTyped<int> >(new PForCompressedColumn<int>("pfor int column",INT)),
+			boost::shared_ptr<ColumnBaseTyped<int> >(new FrequencyPartitionedColumn<int>("frequency partitioned int column",INT)),
+			boost::shared_ptr<ColumnBaseTyped<int> >(new CascadedCompressedColumn<int>("cascaded int column",INT))};
+		const unsigned int number_of_columns = sizeof(cols)/sizeof(cols[0]);
+		//the operands are a plain and a run length compressed column without zeros, the division needs no zero check
+		boost::shared_ptr<Column<int> > plain_operand (new Column<int>("plain operand column",INT));
+		boost::shared_ptr<RunLengthCompressedColumn<int> > compressed_operand (new RunLengthCompressedColumn<int>("compressed operand column",INT));
+		boost::shared_ptr<Column<int> > short_operand (new Column<int>("short operand column",INT));
+		std::vector<int> values;
+		std::vector<int> plain_operands;
+		std::vector<int> compressed_operands;
+		for(int i=0;i<3000;i++){
+			values.push_back(i%7==0 ? rand()%50 : i/100);
+			plain_operands.push_back(rand()%9+1);
+			compressed_operands.push_back(i/500+2);
+			plain_operand->insert(plain_operands.back());
+			compressed_operand->insert(compressed_operands.back());
+			if(i<100) short_operand->insert(1);
+		}
+		for(unsigned int c=0;c<number_of_columns;c++){
+			for(unsigned int i=0;i<values.size();i++){
+				cols[c]->insert(values[i]);
+			}
+			if(!cols[c]->add(ColumnPtr(plain_operand)) || !cols[c]->multiply(ColumnPtr(compressed_operand)) || !cols[c]->minus(ColumnPtr(compressed_operand)) || !cols[c]->division(ColumnPtr(plain_operand))){
+				std::cout << "FAILED! Operation rejected by column " << cols[c]->getName() << std::endl;
+				return -1;
+			}
+			if(cols[c]->add(ColumnPtr(short_operand))){
+				std::cout << "FAILED! Column " << cols[c]->getName() << " accepted an operand of another size" << std::endl;
+				return -1;
+			}
+		}
+		for(unsigned int i=0;i<values.size();i++){
+			values[i] = ((values[i]+plain_operands[i])*compressed_operands[i]-compressed_operands[i])/plain_operands[i];
+		}
+		for(unsigned int c=0;c<number_of_columns;c++){
+			for(unsigned int i=0;i<values.size();i++){
+				if((*cols[c])[i]!=values[i]){
+					std::cout << "FAILED! Wrong value in column " << cols[c]->getName() << " at position " << i << std::endl;
+					return -1;
+				}
+			}
+		}
+		//element wise arithmetic on floats
+		boost::shared_ptr<ColumnBaseTyped<float> > float_col (new XorCompressedColumn<float>("xor float column",FLOAT));
+		boost::shared_ptr<Column<float> > float_operand (new Column<float>("float operand column",FLOAT));
+		std::vector<float> float_values;
+		for(int i=0;i<3000;i++){
+			float_values.push_back(0.25f*(i%40));
+			float_col->insert(float_values.back());
+			float_operand->insert(1.0f);
+		}
+		float_col->add(ColumnPtr(float_operand));
+		for(unsigned int i=0;i<float_values.size();i++){
+			if((*float_col)[i]!=float_values[i]+1.0f){
+				std::cout << "FAILED! Wrong value in column " << float_col->getName() << " at position " << i << std::endl;
+				return -1;
+			}
+		}
+		std::cout << "SUCCESS" << std::endl;
+	}
+
+	/****** BULK UPDATE TEST ******/
+	{
+		std::cout << "BULK UPDATE TEST..."; // << std::endl;
+		boost::shared_ptr<Column<int> > uncompressed_col (new Column<int>("int column",INT));
+		boost::shared_ptr<RunLengthCompressedColumn<int> > compressed_col (new RunLengthCompressedColumn<int>("compressed int column",INT));
+		std::vector<int> reference_data;
+		for(int i=0;i<3000;i++){
+			reference_data.push_back(i%13==0 ? rand()%100 : i/50);
+			//the range insert of the run length column is not implemented
+			uncompressed_col->insert(reference_data.back());
+			compressed_col->insert(reference_data.back());
+		}
+
+		bool result = *(boost::static_pointer_cast<ColumnBaseTyped<int> >(uncompressed_col))==*(boost::static_pointer_cast<ColumnBaseTyped<int> >(compressed_col));
+		if(!result){
+			std::cout << "FAILED! operator== returned false before the update" << std::endl;
+			return -1;
+		}
+		for(unsigned int round=0;round<20;round++){
+			//unsorted TIDs with duplicates, the first rounds include the first and the last row
+			PositionListPtr tids (new PositionList());
+			for(unsigned int i=0;i<10;i++){
+				tids->push_back(rand()%uncompressed_col->size());
+			}
+			tids->push_back(tids->front());
+			if(round<2){
+				tids->push_back(uncompressed_col->size()-1);
+				tids->push_back(0);
+			}
+			//values of neighbouring rows merge the updated rows into existing runs
+			int new_value = (round%2==0) ? rand()%100 : (*uncompressed_col)[(*tids)[0]+((*tids)[0]+1<uncompressed_col->size() ? 1 : 0)];
+
+			uncompressed_col->update(tids,new_value);
+			if(!compressed_col->update(tids,new_value)){
+				std::cout << "FAILED! Update rejected in round " << round << std::endl;
+				return -1;
+			}
+			result = *(boost::static_pointer_cast<ColumnBaseTyped<int> >(uncompressed_col))==*(boost::static_pointer_cast<ColumnBaseTyped<int> >(compressed_col));
+			if(!result){
+				std::cout << "FAILED! Columns differ after round " << round << std::endl;
+				return -1;
+			}
+		}
+		//a TID beyond the last row rejects the whole update
+		PositionListPtr tids (new PositionList(1,0));
+		tids->push_back(compressed_col->size());
+		if(compressed_col->update(tids,-1) || !(*(boost::static_pointer_cast<ColumnBaseTyped<int> >(uncompressed_col))==*(boost::static_pointer_cast<ColumnBaseTyped<int> >(compressed_col)))){
+			std::cout << "FAILED! Update with an invalid TID was not rejected" << std::endl;
+			return -1;
+		}
+		std::cout << "SUCCESS"<< std::endl;
+	}
+
+	/****** BULK DELETE TEST ******/
+	{
+		std::cout << "BULK DELETE TEST..."; // << std::endl;
+		boost::shared_ptr<Column<int> > uncompressed_col (new Column<int>("int column",INT));
+		boost::shared_ptr<RunLengthCompressedColumn<int> > compressed_col (new RunLengthCompressedColumn<int>("compressed int column",INT));
+		for(int i=0;i<3000;i++){
+			int value = i%13==0 ? rand()%100 : i/50;
+			uncompressed_col->insert(value);
+			compressed_col->insert(value);
+		}
+
+		bool result = *(boost::static_pointer_cast<ColumnBaseTyped<int> >(uncompressed_col))==*(boost::static_pointer_cast<ColumnBaseTyped<int> >(compressed_col));
+		if(!result){
+			std::cout << "FAILED! operator== returned false before the delete" << std::endl;
+			return -1;
+		}
+		for(unsigned int round=0;round<20;round++){
+			//unsorted TIDs with duplicates, the first rounds include the first and the last row, later rounds remove whole runs
+			PositionListPtr tids (new PositionList());
+			for(unsigned int i=0;i<10;i++){
+				tids->push_back(rand()%uncompressed_col->size());
+			}
+			tids->push_back(tids->front());
+			if(round<2){
+				tids->push_back(uncompressed_col->size()-1);
+				tids->push_back(0);
+			}
+			if(round>=15){
+				for(TID tid=(*tids)[0];tid<std::min<size_t>((*tids)[0]+60,uncompressed_col->size());tid++) tids->push_back(tid);
+			}
+			//the uncompressed column removes the rows from the back, so it needs a sorted list without duplicates
+			PositionListPtr sorted_tids (new PositionList(*tids));
+			std::sort(sorted_tids->begin(),sorted_tids->end());
+			sorted_tids->erase(std::unique(sorted_tids->begin(),sorted_tids->end()),sorted_tids->end());
+
+			uncompressed_col->remove(sorted_tids);
+			if(!compressed_col->remove(tids)){
+				std::cout << "FAILED! Delete rejected in round " << round << std::endl;
+				return -1;
+			}
+			result = *(boost::static_pointer_cast<ColumnBaseTyped<int> >(uncompressed_col))==*(boost::static_pointer_cast<ColumnBaseTyped<int> >(compressed_col));
+			if(!result){
+				std::cout << "FAILED! Columns differ after round " << round << std::endl;
+				return -1;
+			}
+		}
+		//a TID beyond the last row rejects the whole delete
+		PositionListPtr tids (new PositionList(1,0));
+		tids->push_back(compressed_col->size());
+		if(compressed_col->remove(tids) || !(*(boost::static_pointer_cast<ColumnBaseTyped<int> >(uncompressed_col))==*(boost::static_pointer_cast<ColumnBaseTyped<int> >(compressed_col)))){
+			std::cout << "FAILED! Delete with an invalid TID was not rejected" << std::endl;
+			return -1;
+		}
+		std::cout << "SUCCESS"<< std::endl;
+	}
 
 
  return 0;
@@ -77,6 +77,75 @@ bool equals(std::vector<T> reference_data, boost::shared_ptr<ColumnBaseTyped<T>
 			return false;
 		}
 	}
+	if (reference_data.empty()) return true;
+	// the batch interface has to return the same values as operator[]
+	std::vector<T> values(reference_data.size());
+	col->decode(0, reference_data.size(), &values[0]);
+	if (values != reference_data) {
+		std::cout << "Fatal Error! In Unittest: decode() returned invalid data for column '" << col->getName() << "'" << std::endl;
+		return false;
+	}
+	PositionList tids;
+	for (TID tid = reference_data.size(); tid > 0; tid -= 1 + tid / 64) {
+		tids.push_back(tid - 1);
+	}
+	col->gather(&tids[0], tids.size(), &values[0]);
+	for (unsigned int i = 0; i < tids.size(); i++) {
+		if (values[i] != reference_data[tids[i]]) {
+			std::cout << "Fatal Error! In Unittest: gather() returned invalid data for column '" << col->getName() << "' TID: '" << tids[i] << "'" << std::endl;
+			return false;
+		}
+	}
+	return true;
+}
+
+template<class T>
+bool test_selection(std::vector<T>& reference_data, boost::shared_ptr<ColumnBaseTyped<T> > col) {
+	ValueComparator comparators[] = {EQUAL, LESSER, GREATER};
+	for (unsigned int i = 0; i < 3; i++) {
+		// use an existing value and a (probably) unknown one
+		T values[] = {reference_data[rand() % reference_data.size()], get_rand_value<T>()};
+		for (unsigned int j = 0; j < 2; j++) {
+			PositionList expected;
+			for (TID tid = 0; tid < reference_data.size(); tid++) {
+				if ((comparators[i] == EQUAL && reference_data[tid] == values[j])
+					|| (comparators[i] == LESSER && reference_data[tid] < values[j])
+					|| (comparators[i] == GREATER && reference_data[tid] > values[j])) {
+					expected.push_back(tid);
+				}
+			}
+			PositionListPtr tids = col->selection(values[j], comparators[i]);
+			if (!tids || *tids != expected) {
+				std::cout << "Fatal Error! In Unittest: wrong selection result for value '" << values[j]
+					<< "' and comparator " << comparators[i] << std::endl;
+				return false;
+			}
+			tids = col->parallel_selection(values[j], comparators[i], 4);
+			if (!tids || *tids != expected) {
+				std::cout << "Fatal Error! In Unittest: wrong parallel selection result for value '" << values[j]
+					<< "' and comparator " << comparators[i] << std::endl;
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+/* compares parallel_selection() with selection() for every comparator and value, the column should span several morsels */
+template<class T>
+bool test_parallel_selection(boost::shared_ptr<ColumnBaseTyped<T> > col, const std::vector<T>& values) {
+	ValueComparator comparators[] = {EQUAL, LESSER, GREATER};
+	for (unsigned int i = 0; i < 3; i++) {
+		for (unsigned int j = 0; j < values.size(); j++) {
+			PositionListPtr expected = col->selection(values[j], comparators[i]);
+			PositionListPtr tids = col->parallel_selection(values[j], comparators[i], 4);
+			if (!expected || !tids || *tids != *expected) {
+				std::cout << "Fatal Error! In Unittest: parallel selection of column '" << col->getName() << "' differs from selection for value '"
+					<< values[j] << "' and comparator " << comparators[i] << std::endl;
+				return false;
+			}
+		}
+	}
 	return true;
 }
 
@@ -116,6 +185,13 @@ bool test_column(boost::shared_ptr<ColumnBaseTyped<T> > col, boost::shared_ptr<C
 		return false;
 	}	
 	std::cout << "SUCCESS"<< std::endl;
+	/****** SELECTION TEST ******/
+	std::cout << "SELECTION TEST...";
+	if (!test_selection(reference_data, col)) {
+		std::cerr << "SELECTION TEST FAILED!" << std::endl;
+		return false;
+	}
+	std::cout << "SUCCESS"<< std::endl;
 	/****** UPDATE TEST ******/
 	TID tid = rand() % 100;
 	T new_value = get_rand_value<T>();